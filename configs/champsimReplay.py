@@ -0,0 +1,49 @@
+from archXplore import *
+
+import time
+import sys
+
+class tracedProcess(Process):
+    def __init__(self, trace_file, harts = 1):
+        super().__init__()
+        self.name = "tracedProcess"
+        self.max_harts = harts
+        self.trace_file = trace_file
+
+
+class myCPU(SimpleCPU) :
+    def __init__(self, system, name) :
+        super().__init__(system, name)
+        self.Params.fetch_width = 64
+
+    def buildTopology(self) :
+        pass
+
+# ChampSim traces, plain or compressed with xz or gzip, one core per trace
+traces = sys.argv[1:] if len(sys.argv) > 1 else ["600.perlbench_s-210B.champsimtrace.xz"]
+
+system = System.ChampSimSystem()
+
+boundArea = ClockedObject(system, "boundArea").toBoundPhase()
+
+system.cpus = [myCPU(boundArea, "SimpleCPU" + str(i)).setRank(i) for i in range(len(traces))]
+
+system.build()
+
+for trace in traces:
+    system.newProcess(tracedProcess(trace))
+
+start = time.perf_counter()
+
+system.run()
+
+end = time.perf_counter()
+
+total_instructions = 0
+for cpu in system.cpus:
+    total_instructions += cpu.Statistics.totalInstRetired
+
+print("Host time elapsed(s): ", end-start)
+print("Guest time elapsed(s): ", system.getElapsedTime())
+print("Total instructions executed: ", total_instructions)
+print("Million instructions per second: ", total_instructions/1000000/(end-start))
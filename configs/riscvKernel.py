@@ -0,0 +1,50 @@
+from archXplore import *
+
+import time
+import sys
+
+class kernelProcess(Process):
+    def __init__(self, executable, arguments = []):
+        super().__init__()
+        self.name = "kernelProcess"
+        self.max_harts = 1
+        self.executable = executable
+        self.arguments = arguments
+
+
+class myCPU(SimpleCPU) :
+    def __init__(self, system, name) :
+        super().__init__(system, name)
+        self.Params.fetch_width = 64
+
+    def buildTopology(self) :
+        pass
+
+# Usage: riscvKernel.py <static RV64IMAC executable> [arguments...]
+executable = sys.argv[1] if len(sys.argv) > 1 else "kernel.riscv"
+arguments = sys.argv[2:]
+
+system = System.RiscvSystem()
+
+boundArea = ClockedObject(system, "boundArea").toBoundPhase()
+
+system.cpus = [myCPU(boundArea, "SimpleCPU0").setRank(0)]
+
+system.build()
+
+system.newProcess(kernelProcess(executable, arguments))
+
+start = time.perf_counter()
+
+system.run()
+
+end = time.perf_counter()
+
+total_instructions = 0
+for cpu in system.cpus:
+    total_instructions += cpu.Statistics.totalInstRetired
+
+print("Host time elapsed(s): ", end-start)
+print("Guest time elapsed(s): ", system.getElapsedTime())
+print("Total instructions executed: ", total_instructions)
+print("Million instructions per second: ", total_instructions/1000000/(end-start))
@@ -0,0 +1,52 @@
+from archXplore import *
+
+import time
+import sys
+
+class tracedProcess(Process):
+    def __init__(self, trace_file, shards, warmup_insts):
+        super().__init__()
+        self.name = "tracedProcess"
+        self.trace_file = trace_file
+        self.shards = shards
+        self.warmup_insts = warmup_insts
+
+
+class myCPU(SimpleCPU) :
+    def __init__(self, system, name) :
+        super().__init__(system, name)
+        self.Params.fetch_width = 64
+
+    def buildTopology(self) :
+        pass
+
+# Usage: shardedReplay.py <trace> [shards] [warmup instructions]
+trace = sys.argv[1] if len(sys.argv) > 1 else "helloWorld.trace"
+shards = int(sys.argv[2]) if len(sys.argv) > 2 else 32
+warmup_insts = int(sys.argv[3]) if len(sys.argv) > 3 else 1000000
+
+system = System.TraceSystem()
+
+boundArea = ClockedObject(system, "boundArea").toBoundPhase()
+
+# Every shard runs on its own rank scheduler and host thread
+system.cpus = [myCPU(boundArea, "SimpleCPU" + str(i)).setRank(i) for i in range(shards)]
+
+system.build()
+
+process = system.newProcess(tracedProcess(trace, shards, warmup_insts))
+
+start = time.perf_counter()
+
+system.run()
+
+end = time.perf_counter()
+
+stats = system.getMergedStatistics(process)
+
+print("Host time elapsed(s): ", end-start)
+print("Shards: ", shards, " warmup instructions per shard: ", warmup_insts)
+print("Measured instructions: ", stats["totalInstRetired"])
+print("Measured cycles: ", stats["totalCycle"])
+print("IPC: ", stats["totalInstRetired"] / max(stats["totalCycle"], 1))
+print("Million instructions per second: ", stats["totalInstRetired"]/1000000/(end-start))
@@ -0,0 +1,55 @@
+from archXplore import *
+
+import time
+import sys
+
+class syntheticProcess(Process):
+    def __init__(self):
+        super().__init__()
+        self.name = "synthetic"
+        self.max_harts = 1
+
+
+class myCPU(SimpleCPU) :
+    def __init__(self, system, name) :
+        super().__init__(system, name)
+        self.Params.fetch_width = 64
+
+    def buildTopology(self) :
+        pass
+
+# Usage: syntheticBench.py [harts] [instructions per hart]
+threads = int(sys.argv[1]) if len(sys.argv) > 1 else 64
+num_insts = int(sys.argv[2]) if len(sys.argv) > 2 else 10000000
+
+system = System.SyntheticSystem()
+system.mix.num_insts = num_insts
+system.mix.branch_rate = 0.15
+system.mix.load_rate = 0.25
+system.mix.store_rate = 0.1
+system.mix.pattern = System.AddressPattern.STRIDED
+system.mix.syscall_interval = 100000
+
+boundArea = ClockedObject(system, "boundArea").toBoundPhase()
+
+system.cpus = [myCPU(boundArea, "SimpleCPU" + str(i)).setRank(i) for i in range(threads)]
+
+system.build()
+
+for i in range(threads):
+    system.newProcess(syntheticProcess())
+
+start = time.perf_counter()
+
+system.run()
+
+end = time.perf_counter()
+
+total_instructions = 0
+for cpu in system.cpus:
+    total_instructions += cpu.Statistics.totalInstRetired
+
+print("Host time elapsed(s): ", end-start)
+print("Guest time elapsed(s): ", system.getElapsedTime())
+print("Total instructions executed: ", total_instructions)
+print("Million instructions per second: ", total_instructions/1000000/(end-start))
@@ -0,0 +1,61 @@
+from archXplore import *
+
+import time
+import sys
+
+class idleHarts(Process):
+    def __init__(self, harts):
+        super().__init__()
+        self.name = "helloWorld"
+        self.max_harts = harts
+        self.executable = "/root/hello_riscv"
+
+
+class myCPU(SimpleCPU) :
+    def __init__(self, system, name) :
+        super().__init__(system, name)
+        self.Params.fetch_width = 64
+
+    def buildTopology(self) :
+        pass
+
+# Usage: wakeupBench.py [poll|event] [harts] [harts per process]
+# Only the boot hart of each process runs, the others stay parked. Compare
+# the wakeup checks of both modes.
+mode = sys.argv[1] if len(sys.argv) > 1 else "event"
+threads = int(sys.argv[2]) if len(sys.argv) > 2 else 64
+harts_per_process = int(sys.argv[3]) if len(sys.argv) > 3 else 4
+
+system = System.QemuSystem()
+system.event_wakeup = (mode == "event")
+
+boundArea = ClockedObject(system, "boundArea").toBoundPhase()
+
+system.cpus = [myCPU(boundArea, "SimpleCPU" + str(i)).setRank(i) for i in range(threads)]
+
+system.build()
+
+for i in range(threads // harts_per_process):
+    system.newProcess(idleHarts(harts_per_process))
+
+start = time.perf_counter()
+
+system.run()
+
+end = time.perf_counter()
+
+total_instructions = 0
+total_cycles = 0
+wakeup_checks = 0
+for cpu in system.cpus:
+    total_instructions += cpu.Statistics.totalInstRetired
+    total_cycles += cpu.Statistics.totalCycle
+    wakeup_checks += cpu.Statistics.wakeUpChecks
+
+print("Wakeup mode: ", mode)
+print("Host time elapsed(s): ", end-start)
+print("Guest time elapsed(s): ", system.getElapsedTime())
+print("Total instructions executed: ", total_instructions)
+print("Total active cycles: ", total_cycles)
+print("Wakeup monitor checks: ", wakeup_checks)
+print("Million instructions per second: ", total_instructions/1000000/(end-start))
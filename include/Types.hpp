@@ -13,4 +13,6 @@ namespace archXplore
 
         typedef uint64_t Addr_t;
 
+        typedef uint64_t BlockID_t;
+
 } // namespace archXplore
\ No newline at end of file
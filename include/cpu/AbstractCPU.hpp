@@ -1,6 +1,9 @@
 #pragma once
 
 #include <atomic>
+#include <limits>
+#include <map>
+#include <unordered_map>
 
 #include "sparta/events/UniqueEvent.hpp"
 #include "sparta/simulation/Unit.hpp"
@@ -114,6 +117,15 @@ namespace archXplore
              **/
             auto cancelWakeUpMonitorEvent() -> void;
 
+            /**
+             * @brief Request a check of the wakeup monitor
+             *
+             * This function can be called from any thread, e.g. when new events
+             * arrive for a parked CPU. The check runs at the next wakeup drain of
+             * the system.
+             **/
+            auto notifyWakeUp() -> void;
+
             /**
              * @brief Schedule the next tick event
              *
@@ -191,6 +203,32 @@ namespace archXplore
              */
             auto setProcess(system::Process *process) -> void;
 
+            /**
+             * @brief Reset the statistics
+             *
+             * This function is called to start measuring from the current point,
+             * e.g. after a warmup period. Counters keep running, later reads are
+             * taken relative to their values now.
+             */
+            virtual auto resetStatistics() -> void;
+
+            /**
+             * @brief Reset the statistics once more instructions retired
+             *
+             * This function is called to end a warmup period when its last
+             * instruction retires rather than when it is fetched.
+             * @param num_insts Number of instructions left to retire before the reset.
+             */
+            auto resetStatisticsAfter(const uint64_t &num_insts) -> void;
+
+            /**
+             * @brief Get the statistics
+             *
+             * This function is called to get the counters since the last reset.
+             * @return Counter values by name.
+             */
+            auto getStatistics() -> std::map<std::string, uint64_t>;
+
         public:
             // CPU Status
             cpuStatus_t m_status;
@@ -200,6 +238,14 @@ namespace archXplore
             sparta::Counter m_cycle;
             // Instruction retired counter
             sparta::Counter m_instret;
+            // Fetches that waited for the ISS to produce events
+            sparta::Counter m_iss_wait_count;
+            // Host time spent waiting for the ISS in nanoseconds, by stage of the wait policy
+            sparta::Counter m_iss_spin_time;
+            sparta::Counter m_iss_yield_time;
+            sparta::Counter m_iss_block_time;
+            // Wakeup monitor checks
+            sparta::Counter m_wakeup_checks;
             // Unique Hart Id
             HartID_t m_hart_id;
             // Processor frequency
@@ -208,6 +254,25 @@ namespace archXplore
             sparta::log::MessageSource m_trace_logger;
             // Process pointer
             system::Process *m_process;
+            // A wakeup check was requested and not drained yet
+            std::atomic<bool> m_wakeup_requested{false};
+            // Waiting for a notification instead of checking every cycle
+            bool m_parked = false;
+
+        protected:
+            /**
+             * @brief Retire an instruction
+             *
+             * CPU models call this function for each retired instruction.
+             */
+            inline auto retireInst() -> void
+            {
+                m_instret++;
+                if (SPARTA_EXPECT_FALSE(m_instret.get() == m_reset_instret))
+                {
+                    resetStatistics();
+                }
+            };
 
         protected:
             // ISS Ptr
@@ -218,6 +283,10 @@ namespace archXplore
             sparta::UniqueEvent<sparta::SchedulingPhase::Tick> m_tick_event;
             // Startup event
             sparta::UniqueEvent<sparta::SchedulingPhase::Tick> m_startup_event;
+            // Counter values at the last statistics reset
+            std::unordered_map<const sparta::CounterBase *, uint64_t> m_stat_baseline;
+            // Retired instruction count at which the statistics are reset
+            uint64_t m_reset_instret = std::numeric_limits<uint64_t>::max();
         };
 
     } // namespace iss
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Types.hpp"
+
+namespace archXplore
+{
+    namespace cpu
+    {
+
+        struct BlockMemAccess_t
+        {
+            // Effective address
+            Addr_t vaddr;
+            // Index of the accessing instruction within the block
+            uint16_t index;
+            // Log2 of the access size
+            uint8_t size_shift;
+            // Store or load
+            bool is_store;
+        };
+
+        struct BlockEvent_t
+        {
+            /**
+             * Maximum number of memory accesses carried by a single record,
+             * chosen so that a block record is not larger than an instruction event
+             */
+            static constexpr size_t MAX_MEM_ACCESSES = 5;
+
+            // Identifier of the executed block
+            BlockID_t block_id;
+            // Number of valid memory accesses
+            uint8_t num_mem;
+            // The accesses of this block continue in the next record
+            bool has_more;
+            // Memory accesses in program order
+            BlockMemAccess_t mem[MAX_MEM_ACCESSES];
+        };
+
+        struct BlockDefine_t
+        {
+            // Identifier of the translated block
+            BlockID_t block_id;
+            // Start address of the block
+            Addr_t pc;
+            // Number of instructions, sent as instruction events right after this one
+            uint16_t num_insts;
+        };
+
+    } // namespace cpu
+} // namespace archXplore
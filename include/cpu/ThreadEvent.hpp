@@ -10,6 +10,7 @@
 #include "cpu/StaticInst.hpp"
 #include "cpu/PthreadAPI.hpp"
 #include "cpu/SyscallAPI.hpp"
+#include "cpu/BlockEvent.hpp"
 
 namespace archXplore
 {
@@ -31,7 +32,11 @@ namespace archXplore
 
                 THREAD_API, // Calls to thread library
 
-                SYSCALL_API // Calls to syscall api
+                SYSCALL_API, // Calls to syscall api
+
+                BLOCK, // Executed basic block records
+
+                BLOCK_DEFINE // Static basic block definitions
 
             };
 
@@ -47,6 +52,12 @@ namespace archXplore
             using SyscallApiTagType = std::integral_constant<Tag, Tag::SYSCALL_API>;
             static constexpr auto SyscallApiTag = SyscallApiTagType{};
 
+            using BlockTagType = std::integral_constant<Tag, Tag::BLOCK>;
+            static constexpr auto BlockTag = BlockTagType{};
+
+            using BlockDefineTagType = std::integral_constant<Tag, Tag::BLOCK_DEFINE>;
+            static constexpr auto BlockDefineTag = BlockDefineTagType{};
+
             /**
              * The actual event.
              * An event stream is a sequence of any of the union'd types.
@@ -59,6 +70,8 @@ namespace archXplore
                 StaticInst_t instruction;
                 SyscallAPI_t syscall_api;
                 PthreadAPI_t pthread_api;
+                BlockEvent_t block;
+                BlockDefine_t block_define;
             };
 
             const Tag tag = Tag::UNDEFINED;
@@ -76,6 +89,12 @@ namespace archXplore
             ThreadEvent_t(SyscallApiTagType, const EventID_t& event_id, const SyscallAPI_t& data) noexcept
                 : syscall_api(data), tag{Tag::SYSCALL_API}, event_id{event_id} {}
 
+            ThreadEvent_t(BlockTagType, const EventID_t& event_id, const BlockEvent_t& data) noexcept
+                : block(data), tag{Tag::BLOCK}, event_id{event_id} {}
+
+            ThreadEvent_t(BlockDefineTagType, const EventID_t& event_id, const BlockDefine_t& data) noexcept
+                : block_define(data), tag{Tag::BLOCK_DEFINE}, event_id{event_id} {}
+
             ~ThreadEvent_t(){};
 
             ThreadEvent_t(const archXplore::cpu::ThreadEvent_t& that) 
@@ -92,6 +111,12 @@ namespace archXplore
                     case Tag::SYSCALL_API:
                         new (&syscall_api) SyscallAPI_t(that.syscall_api);
                         break;
+                    case Tag::BLOCK:
+                        new (&block) BlockEvent_t(that.block);
+                        break;
+                    case Tag::BLOCK_DEFINE:
+                        new (&block_define) BlockDefine_t(that.block_define);
+                        break;
                     default:
                         break;
                 }
@@ -7,6 +7,7 @@
 
 #include "Types.hpp"
 #include "cpu/ThreadEvent.hpp"
+#include "iss/FetchGroup.hpp"
 
 // Forward Declaration
 namespace archXplore::cpu
@@ -47,9 +48,9 @@ namespace archXplore
              * This function should be called when the CPU receives a fetch response from the memory system.
              *
              * @param data Pointer to the fetched data
-             * @param length Length of the fetched data in bytes
+             * @return View of the fetched instructions, valid until the next fetch request
              */
-            virtual inline auto processFetchResponse(const uint8_t* data) -> std::vector<cpu::StaticInst_t> = 0;
+            virtual inline auto processFetchResponse(const uint8_t* data) -> FetchGroup_t = 0;
 
             // Delete copy-construct function
             AbstractISS(const AbstractISS &that) = delete;
@@ -82,6 +83,18 @@ namespace archXplore
              */
             virtual inline auto wakeUpMonitor() -> void = 0;
 
+            /**
+             * @brief Check whether the ISS notifies the CPU when it may wake up
+             *
+             * A notified CPU checks the wakeup monitor only when notified instead
+             * of every cycle.
+             * @return True if the CPU is notified
+             */
+            virtual inline auto notifiesWakeUp() const -> bool
+            {
+                return false;
+            };
+
             /**
              * @brief Set the CPU pointer
              * @param cpu CPU pointer
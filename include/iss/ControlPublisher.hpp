@@ -0,0 +1,73 @@
+#pragma once
+
+#include "iceoryx_posh/popo/publisher.hpp"
+
+#include "iss/IPCConfig.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+
+        class ControlPublisher
+        {
+        public:
+            ControlPublisher(const ControlPublisher &rhs) = delete;
+            ControlPublisher &operator=(const ControlPublisher &rhs) = delete;
+
+            /**
+             * @brief Constructor
+             * @param app_name Application name
+             * @param pid Process ID of the controlled QEMU process
+             */
+            ControlPublisher(const std::string &app_name, const ProcessID_t &pid)
+                : m_app_name(app_name), m_pid(pid)
+            {
+                // The last request is kept for a QEMU process that subscribes late
+                iox::popo::PublisherOptions publisherOptions;
+                publisherOptions.historyCapacity = 1;
+
+                auto app_name_str = iox::into<iox::lossy<iox::capro::IdString_t>>(app_name);
+                auto instance_str = iox::into<iox::lossy<iox::capro::IdString_t>>(std::to_string(pid));
+                auto event_name_str = iox::into<iox::lossy<iox::capro::IdString_t>>(std::string(CONTROL_SERVICE));
+
+                // Create publisher
+                m_publisher.reset(new iox::popo::Publisher<ControlMessage_t>(
+                    {app_name_str, instance_str, event_name_str}, publisherOptions));
+            };
+
+            /**
+             * @brief Destructor
+             */
+            ~ControlPublisher()
+            {
+                m_publisher->stopOffer();
+            };
+
+            /**
+             * @brief Request a new instrumentation mode
+             * @param mode The requested mode
+             * @param budget Instructions to run in the requested mode, zero keeps it until the next request
+             *
+             * @return void
+             */
+            auto send(const InstrumentMode_t &mode, const uint64_t &budget = 0) -> void
+            {
+                while (!m_publisher->publishCopyOf(ControlMessage_t{mode, budget}))
+                {
+                    continue;
+                }
+            };
+
+        private:
+            // Application name
+            const std::string m_app_name;
+            // Process ID
+            const ProcessID_t m_pid;
+            // Publisher
+            std::unique_ptr<iox::popo::Publisher<ControlMessage_t>> m_publisher;
+        };
+
+    } // namespace iss
+
+} // namespace archXplore
@@ -0,0 +1,397 @@
+#pragma once
+
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#include "iss/IPCConfig.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+
+        /**
+         * @brief Stream state shared by the encoder and the decoder
+         *
+         * Both sides start every chunk from the same zero state and advance it with
+         * every event, so a chunk can be decoded on its own.
+         */
+        class EventCodecState
+        {
+        protected:
+            /*
+             * @brief Flags of a record header byte
+             */
+            enum Flag_t : uint8_t
+            {
+                RAW_RECORD = 1 << 0,  // The event follows as a plain ThreadEvent_t
+                FALL_THROUGH = 1 << 1, // pc is the end of the previous instruction
+                SEQUENTIAL = 1 << 2,   // Event and instruction ids follow the previous ones
+                NEW_MEMORY = 1 << 3,   // Memory information differs from the previous instruction
+                REDIRECT = 1 << 4,     // Branch redirect flag
+                NEW_TARGET = 1 << 5,   // Branch target is not the fall-through address
+                IS_LAST = 1 << 6,      // Last event of the hart
+                SAME_LENGTH = 1 << 7   // Instruction length equals the previous one
+            };
+
+            /**
+             * @brief Reset the stream state at the start of a chunk
+             *
+             * @return void
+             */
+            inline auto resetState() -> void
+            {
+                m_pc = 0;
+                m_len = 0;
+                m_event_id = 0;
+                m_uid = 0;
+                m_mem_info = cpu::MemoryInfo_t{0, 0, false};
+            };
+
+            /**
+             * @brief Advance the stream state past an event
+             * @param ev The event
+             *
+             * @return void
+             */
+            inline auto advance(const cpu::ThreadEvent_t &ev) -> void
+            {
+                m_event_id = ev.event_id;
+                if (ev.tag == cpu::ThreadEvent_t::Tag::INSTRUCTION)
+                {
+                    m_pc = ev.instruction.pc;
+                    m_len = ev.instruction.len;
+                    m_uid = ev.instruction.uid;
+                    m_mem_info = ev.instruction.mem_info;
+                }
+            };
+
+            static inline auto zigzag(const int64_t &value) -> uint64_t
+            {
+                return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+            };
+
+            static inline auto unzigzag(const uint64_t &value) -> int64_t
+            {
+                return int64_t(value >> 1) ^ -int64_t(value & 1);
+            };
+
+        protected:
+            // Previous instruction address
+            Addr_t m_pc = 0;
+            // Previous instruction length
+            uint8_t m_len = 0;
+            // Previous event ID
+            EventID_t m_event_id = 0;
+            // Previous instruction ID
+            EventID_t m_uid = 0;
+            // Previous memory information
+            cpu::MemoryInfo_t m_mem_info{0, 0, false};
+        };
+
+        /**
+         * @brief Delta/varint encoder of an event stream
+         *
+         * An instruction whose registers and function information are unset becomes
+         * a header byte of flags followed by only what the flags cannot imply:
+         * zigzag varint deltas of pc, event id and instruction id, the length, the
+         * opcode bytes, the branch target relative to pc and the memory access
+         * with a varint delta of the effective address. Every other event is stored
+         * as a raw record.
+         */
+        class EventEncoder : public EventCodecState
+        {
+        public:
+            // Upper bound of the encoded size of one event
+            static constexpr size_t MAX_RECORD_SIZE = 1 + sizeof(cpu::ThreadEvent_t);
+
+            // Expected number of encoded instructions in the space of one raw event
+            static constexpr size_t EVENTS_PER_SLOT = 8;
+
+            /**
+             * @brief Start encoding into a new buffer
+             * @param begin Beginning of the buffer
+             * @param size Size of the buffer in bytes
+             *
+             * @return void
+             */
+            inline auto reset(uint8_t *begin, const size_t &size) -> void
+            {
+                m_begin = begin;
+                m_cursor = begin;
+                m_end = begin + size;
+                resetState();
+            };
+
+            /**
+             * @brief Check whether the buffer may not hold another event
+             * @return True if the buffer is full
+             */
+            inline auto full() const -> bool
+            {
+                return size_t(m_end - m_cursor) < MAX_RECORD_SIZE;
+            };
+
+            /**
+             * @brief Get the number of bytes written
+             * @return Number of bytes
+             */
+            inline auto size() const -> size_t
+            {
+                return m_cursor - m_begin;
+            };
+
+            /**
+             * @brief Append an event, the buffer must not be full
+             * @param ev The event
+             *
+             * @return void
+             */
+            inline auto encode(const cpu::ThreadEvent_t &ev) -> void
+            {
+                if (ev.tag == cpu::ThreadEvent_t::Tag::INSTRUCTION && isCompact(ev.instruction))
+                {
+                    encodeInstruction(ev);
+                }
+                else
+                {
+                    *m_cursor++ = RAW_RECORD;
+                    std::memcpy(m_cursor, &ev, sizeof(cpu::ThreadEvent_t));
+                    m_cursor += sizeof(cpu::ThreadEvent_t);
+                }
+                advance(ev);
+            };
+
+        private:
+            /**
+             * @brief Check whether an instruction is representable by a compact record
+             * @param inst The instruction
+             * @return True if only the coded fields are set
+             */
+            static inline auto isCompact(const cpu::StaticInst_t &inst) -> bool
+            {
+                const bool opcode_fits = inst.len >= 4 || (uint64_t(inst.opcode) >> (8 * inst.len)) == 0;
+                return opcode_fits && inst.mem_info.len < 0x80 && inst.func_info == cpu::TYPE_UNKNOWN &&
+                       inst.src_reg1.type == cpu::REG_TYPE_NONE && inst.src_reg1.id == 0 &&
+                       inst.src_reg2.type == cpu::REG_TYPE_NONE && inst.src_reg2.id == 0 &&
+                       inst.src_reg3.type == cpu::REG_TYPE_NONE && inst.src_reg3.id == 0 &&
+                       inst.dst_reg.type == cpu::REG_TYPE_NONE && inst.dst_reg.id == 0;
+            };
+
+            inline auto encodeInstruction(const cpu::ThreadEvent_t &ev) -> void
+            {
+                const cpu::StaticInst_t &inst = ev.instruction;
+                const bool fall_through = inst.pc == m_pc + m_len;
+                const bool sequential = ev.event_id == m_event_id + 1 && inst.uid == m_uid + 1;
+                const bool new_memory = inst.mem_info.vaddr != m_mem_info.vaddr ||
+                                        inst.mem_info.len != m_mem_info.len ||
+                                        inst.mem_info.is_store != m_mem_info.is_store;
+                const bool new_target = inst.br_info.target_pc != inst.pc + inst.len;
+                const bool same_length = inst.len == m_len;
+
+                *m_cursor++ = (fall_through ? FALL_THROUGH : 0) | (sequential ? SEQUENTIAL : 0) |
+                              (new_memory ? NEW_MEMORY : 0) | (inst.br_info.redirect ? REDIRECT : 0) |
+                              (new_target ? NEW_TARGET : 0) | (ev.is_last ? IS_LAST : 0) |
+                              (same_length ? SAME_LENGTH : 0);
+                if (!fall_through)
+                {
+                    writeVarint(zigzag(int64_t(inst.pc - m_pc)));
+                }
+                if (!sequential)
+                {
+                    writeVarint(zigzag(int64_t(ev.event_id - m_event_id)));
+                    writeVarint(zigzag(int64_t(inst.uid - m_uid)));
+                }
+                if (!same_length)
+                {
+                    *m_cursor++ = inst.len;
+                }
+                const size_t opcode_bytes = inst.len < 4 ? inst.len : 4;
+                for (size_t i = 0; i < opcode_bytes; ++i)
+                {
+                    *m_cursor++ = uint8_t(inst.opcode >> (8 * i));
+                }
+                if (new_target)
+                {
+                    writeVarint(zigzag(int64_t(inst.br_info.target_pc - inst.pc)));
+                }
+                if (new_memory)
+                {
+                    *m_cursor++ = inst.mem_info.len | (inst.mem_info.is_store ? 0x80 : 0);
+                    writeVarint(zigzag(int64_t(inst.mem_info.vaddr - m_mem_info.vaddr)));
+                }
+            };
+
+            inline auto writeVarint(uint64_t value) -> void
+            {
+                while (value >= 0x80)
+                {
+                    *m_cursor++ = uint8_t(value) | 0x80;
+                    value >>= 7;
+                }
+                *m_cursor++ = uint8_t(value);
+            };
+
+        private:
+            // Beginning of the buffer
+            uint8_t *m_begin = nullptr;
+            // Next byte to write
+            uint8_t *m_cursor = nullptr;
+            // End of the buffer
+            uint8_t *m_end = nullptr;
+        };
+
+        /**
+         * @brief Streaming decoder of an EventEncoder byte stream
+         */
+        class EventDecoder : public EventCodecState
+        {
+        public:
+            EventDecoder() = default;
+
+            EventDecoder(const EventDecoder &rhs) = delete;
+            EventDecoder &operator=(const EventDecoder &rhs) = delete;
+
+            ~EventDecoder()
+            {
+                clear();
+            };
+
+            /**
+             * @brief Start decoding a new buffer and decode its first event
+             * @param begin Beginning of the buffer
+             * @param num_events Number of events in the buffer
+             *
+             * @return void
+             */
+            inline auto reset(const uint8_t *begin, const size_t &num_events) -> void
+            {
+                clear();
+                m_cursor = begin;
+                m_remaining = num_events;
+                resetState();
+                next();
+            };
+
+            /**
+             * @brief Check whether all events were consumed
+             * @return True if no current event is left
+             */
+            inline auto empty() const -> bool
+            {
+                return !m_has_current;
+            };
+
+            /**
+             * @brief Get the current event
+             * @return The current event
+             */
+            inline auto current() const -> const cpu::ThreadEvent_t &
+            {
+                return *std::launder(reinterpret_cast<const cpu::ThreadEvent_t *>(&m_storage));
+            };
+
+            /**
+             * @brief Decode the next event
+             *
+             * @return void
+             */
+            inline auto next() -> void
+            {
+                clear();
+                if (m_remaining == 0)
+                {
+                    return;
+                }
+                m_remaining--;
+                const uint8_t flags = *m_cursor++;
+                if (flags & RAW_RECORD)
+                {
+                    std::memcpy(&m_storage, m_cursor, sizeof(cpu::ThreadEvent_t));
+                    m_cursor += sizeof(cpu::ThreadEvent_t);
+                }
+                else
+                {
+                    decodeInstruction(flags);
+                }
+                m_has_current = true;
+                advance(current());
+            };
+
+        private:
+            inline auto decodeInstruction(const uint8_t &flags) -> void
+            {
+                cpu::StaticInst_t inst{};
+                EventID_t event_id = m_event_id + 1;
+                inst.uid = m_uid + 1;
+                inst.pc = m_pc + m_len;
+                if (!(flags & FALL_THROUGH))
+                {
+                    inst.pc = m_pc + unzigzag(readVarint());
+                }
+                if (!(flags & SEQUENTIAL))
+                {
+                    event_id = m_event_id + unzigzag(readVarint());
+                    inst.uid = m_uid + unzigzag(readVarint());
+                }
+                inst.len = (flags & SAME_LENGTH) ? m_len : *m_cursor++;
+                const size_t opcode_bytes = inst.len < 4 ? inst.len : 4;
+                for (size_t i = 0; i < opcode_bytes; ++i)
+                {
+                    inst.opcode |= uint32_t(*m_cursor++) << (8 * i);
+                }
+                inst.br_info.redirect = flags & REDIRECT;
+                inst.br_info.target_pc = inst.pc + inst.len;
+                if (flags & NEW_TARGET)
+                {
+                    inst.br_info.target_pc = inst.pc + unzigzag(readVarint());
+                }
+                inst.mem_info = m_mem_info;
+                if (flags & NEW_MEMORY)
+                {
+                    const uint8_t mem = *m_cursor++;
+                    inst.mem_info.len = mem & 0x7f;
+                    inst.mem_info.is_store = mem & 0x80;
+                    inst.mem_info.vaddr = m_mem_info.vaddr + unzigzag(readVarint());
+                }
+                auto ev = new (&m_storage) cpu::ThreadEvent_t(cpu::ThreadEvent_t::InsnTag, event_id, inst);
+                ev->is_last = flags & IS_LAST;
+            };
+
+            inline auto readVarint() -> uint64_t
+            {
+                uint64_t value = 0;
+                size_t shift = 0;
+                while (*m_cursor & 0x80)
+                {
+                    value |= uint64_t(*m_cursor++ & 0x7f) << shift;
+                    shift += 7;
+                }
+                value |= uint64_t(*m_cursor++) << shift;
+                return value;
+            };
+
+            inline auto clear() -> void
+            {
+                if (m_has_current)
+                {
+                    std::launder(reinterpret_cast<cpu::ThreadEvent_t *>(&m_storage))->~ThreadEvent_t();
+                    m_has_current = false;
+                }
+            };
+
+        private:
+            // Next byte to read
+            const uint8_t *m_cursor = nullptr;
+            // Events left after the current one
+            size_t m_remaining = 0;
+            // The current event is valid
+            bool m_has_current = false;
+            // Storage of the current event
+            std::aligned_storage_t<sizeof(cpu::ThreadEvent_t), alignof(cpu::ThreadEvent_t)> m_storage;
+        };
+
+    } // namespace iss
+
+} // namespace archXplore
@@ -1,8 +1,13 @@
 #pragma once
 
-#include "iceoryx_posh/popo/publisher.hpp"
+#include <new>
+
+#include "iceoryx_posh/popo/untyped_publisher.hpp"
 
 #include "iss/IPCConfig.hpp"
+#include "iss/EventCodec.hpp"
+#include "iss/FlushPolicy.hpp"
+#include "iss/WaitPolicy.hpp"
 
 namespace archXplore
 {
@@ -15,14 +20,36 @@ namespace archXplore
             EventPublisher(const EventPublisher &rhs) = delete;
             EventPublisher &operator=(const EventPublisher &rhs) = delete;
 
+            /**
+             * @brief Constructor of a hart event stream publisher
+             * @param app_name Application name
+             * @param hart_id Hart ID
+             * @param latency Latency bound of a buffered event, zero disables the bound
+             * @param encoding Payload encoding of the chunks
+             * @param wait_policy How to wait for a free chunk
+             */
+            EventPublisher(const std::string &app_name, const HartID_t &hart_id,
+                           const std::chrono::microseconds &latency = std::chrono::microseconds(1000),
+                           const EventEncoding_t &encoding = EventEncoding_t::RAW,
+                           const WaitPolicy_t &wait_policy = WaitPolicy_t{})
+                : EventPublisher(app_name, std::to_string(hart_id), THREAD_EVENT_SERVICE, latency, encoding, wait_policy){};
+
             /**
              * @brief Constructor
              * @param app_name Application name
-             * @param pid Process ID
-             * @param tid Thread ID
+             * @param instance Service instance name
+             * @param event_name Service event name
+             * @param latency Latency bound of a buffered event, zero disables the bound
+             * @param encoding Payload encoding of the chunks
+             * @param wait_policy How to wait for a free chunk
              */
-            EventPublisher(const std::string &app_name, const HartID_t &hart_id)
-                : m_app_name(app_name), m_hart_id(hart_id)
+            EventPublisher(const std::string &app_name, const std::string &instance, const std::string &event_name,
+                           const std::chrono::microseconds &latency = std::chrono::microseconds(0),
+                           const EventEncoding_t &encoding = EventEncoding_t::RAW,
+                           const WaitPolicy_t &wait_policy = WaitPolicy_t{})
+                : m_app_name(app_name), m_instance(instance), m_encoding(encoding),
+                  m_events_per_slot(encoding == EventEncoding_t::DELTA ? EventEncoder::EVENTS_PER_SLOT : 1),
+                  m_flush_policy(latency, MESSAGE_VECTOR_SIZE * m_events_per_slot), m_waiter(wait_policy)
             {
                 // Configure publisher options
                 iox::popo::PublisherOptions publisherOptions;
@@ -30,15 +57,18 @@ namespace archXplore
                 publisherOptions.subscriberTooSlowPolicy = iox::popo::ConsumerTooSlowPolicy::WAIT_FOR_CONSUMER;
 
                 auto app_name_str = iox::into<iox::lossy<iox::capro::IdString_t>>(app_name);
-                auto instance_str = iox::into<iox::lossy<iox::capro::IdString_t>>(std::to_string(hart_id));
-                auto event_name_str = iox::into<iox::lossy<iox::capro::IdString_t>>(std::string("ThreadEvent"));
+                auto instance_str = iox::into<iox::lossy<iox::capro::IdString_t>>(instance);
+                auto event_name_str = iox::into<iox::lossy<iox::capro::IdString_t>>(event_name);
 
                 // Create publisher
-                m_publisher.reset(new iox::popo::Publisher<Message_t>(
+                m_publisher.reset(new iox::popo::UntypedPublisher(
                     {app_name_str, instance_str, event_name_str}, publisherOptions));
 
                 // Initialize publisher
                 init();
+
+                // Events are built directly in shared memory
+                loan();
             }
 
             /**
@@ -67,8 +97,14 @@ namespace archXplore
              *
              * @return void
              */
-            auto shutdown(bool wait_for_subscribers = true) const -> void
+            auto shutdown(bool wait_for_subscribers = true) -> void
             {
+                // Return the unused loan to the mempool
+                if (m_chunk != nullptr)
+                {
+                    m_publisher->release(m_chunk);
+                    m_chunk = nullptr;
+                }
                 while(wait_for_subscribers && m_publisher->hasSubscribers())
                 {
                     std::this_thread::sleep_for(std::chrono::milliseconds(1));
@@ -79,7 +115,7 @@ namespace archXplore
 
             /**
              * @brief Publish event
-             * @param force_publish Force publish even if the sample is not full
+             * @param force_publish Publish the chunk now regardless of the flush policy
              * @param args Arguments to forward to the event
              *
              * @return void
@@ -87,26 +123,126 @@ namespace archXplore
             template <typename... Args>
             inline auto publish(const bool &force_publish, Args &&...args) -> void
             {
-                m_event_buffer.emplace_back(std::forward<Args>(args)...);
-                if (m_event_buffer.size() == m_event_buffer.capacity() || force_publish)
+                EventChunkHeader_t &chunk = *m_chunk;
+                bool chunk_full;
+                if (m_encoding == EventEncoding_t::DELTA)
+                {
+                    m_encoder.encode(cpu::ThreadEvent_t(std::forward<Args>(args)...));
+                    chunk.num_events++;
+                    chunk_full = m_encoder.full();
+                }
+                else
+                {
+                    new (&chunk.events()[chunk.num_events++]) cpu::ThreadEvent_t(std::forward<Args>(args)...);
+                    chunk_full = chunk.num_events == chunk.capacity;
+                }
+                if (__glibc_unlikely(force_publish))
+                {
+                    m_flush_policy.forced(chunk.num_events);
+                    flush();
+                }
+                else if (__glibc_unlikely(m_flush_policy.shouldFlush(chunk.num_events) || chunk_full))
+                {
+                    flush();
+                }
+            };
+
+            /**
+             * @brief Publish all buffered events
+             *
+             * @return void
+             */
+            inline auto flush() -> void
+            {
+                const size_t num_events = m_chunk->num_events;
+                if (num_events == 0)
                 {
-                    while (!m_publisher->publishCopyOf(m_event_buffer))
+                    return;
+                }
+                m_chunk->num_bytes = m_encoder.size();
+                const auto start = std::chrono::steady_clock::now();
+                m_publisher->publish(m_chunk);
+                m_chunk = nullptr;
+                // Loan the next chunk ahead of the next event
+                loan();
+                m_flush_policy.published(num_events, std::chrono::steady_clock::now() - start);
+            };
+
+            /**
+             * @brief Get the decisions of the flush policy
+             * @return Flush statistics
+             */
+            inline auto getFlushStats() const -> const FlushStats_t &
+            {
+                return m_flush_policy.getStats();
+            };
+
+            /**
+             * @brief Get the time spent waiting for free chunks
+             * @return Wait statistics of every stage
+             */
+            inline auto getWaitStats() const -> const WaitStats_t &
+            {
+                return m_waiter.getStats();
+            };
+
+        private:
+            /**
+             * @brief Loan a chunk sized for the current batch, falling back to smaller
+             *        size classes and waiting only when all of them are exhausted
+             *
+             * iceoryx does not signal freed chunks, so a blocked publisher sleeps
+             * for the block timeout between attempts.
+             *
+             * @return void
+             */
+            inline auto loan() -> void
+            {
+                // Smallest size class holding a full batch
+                const size_t batch_slots = (m_flush_policy.getStats().batch_size + m_events_per_slot - 1) / m_events_per_slot;
+                size_t first_class = 0;
+                while (first_class + 1 < EVENT_CHUNK_CLASSES.size() &&
+                       EVENT_CHUNK_CLASSES[first_class].capacity < batch_slots)
+                {
+                    first_class++;
+                }
+                auto try_loan = [this, first_class]()
+                {
+                    for (size_t i = first_class + 1; i-- > 0 && m_chunk == nullptr;)
                     {
-                        continue;
+                        const size_t capacity = EVENT_CHUNK_CLASSES[i].capacity;
+                        auto result = m_publisher->loan(eventChunkSize(capacity), alignof(EventChunkHeader_t));
+                        if (result.has_value())
+                        {
+                            m_chunk = new (result.value()) EventChunkHeader_t{0, uint32_t(capacity), 0, m_encoding};
+                        }
                     }
-                    m_event_buffer.clear();
-                }
+                    return m_chunk != nullptr;
+                };
+                m_waiter.wait(try_loan, [](const std::chrono::microseconds &timeout)
+                              { std::this_thread::sleep_for(timeout); });
+                m_encoder.reset(m_chunk->bytes(), m_chunk->capacity * sizeof(cpu::ThreadEvent_t));
             };
 
         private:
             // Application name
             const std::string m_app_name;
-            // Hart ID
-            const HartID_t m_hart_id;
+            // Service instance
+            const std::string m_instance;
             // Publisher
-            std::unique_ptr<iox::popo::Publisher<Message_t>> m_publisher;
-            // Event buffer
-            Message_t m_event_buffer;
+            std::unique_ptr<iox::popo::UntypedPublisher> m_publisher;
+            // Payload encoding
+            const EventEncoding_t m_encoding;
+            // Events expected in the space of one raw event
+            const size_t m_events_per_slot;
+            // Loaned chunk the next events are written to
+            EventChunkHeader_t *m_chunk = nullptr;
+            // Encoder of the loaned chunk
+            EventEncoder m_encoder;
+            // Chunk size and latency policy
+            FlushPolicy m_flush_policy;
+            // Waits for free chunks
+            AdaptiveWaiter m_waiter;
         };
 
     } // namespace iss
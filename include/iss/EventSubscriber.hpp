@@ -1,28 +1,75 @@
 #pragma once
 
-#include "iceoryx_posh/popo/subscriber.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "iceoryx_posh/popo/listener.hpp"
+#include "iceoryx_posh/popo/untyped_subscriber.hpp"
+#include "iceoryx_posh/popo/wait_set.hpp"
 
 #include "iss/IPCConfig.hpp"
+#include "iss/EventCodec.hpp"
+#include "iss/FetchGroup.hpp"
+#include "iss/WaitPolicy.hpp"
 
 namespace archXplore
 {
     namespace iss
     {
 
+        /*
+         * @brief Contiguous run of ready events
+         */
+        struct EventSpan_t
+        {
+            const cpu::ThreadEvent_t *events;
+            size_t count;
+
+            inline auto size() const -> size_t
+            {
+                return count;
+            };
+
+            inline auto operator[](const size_t &index) const -> const cpu::ThreadEvent_t &
+            {
+                return events[index];
+            };
+
+            inline auto begin() const -> const cpu::ThreadEvent_t *
+            {
+                return events;
+            };
+
+            inline auto end() const -> const cpu::ThreadEvent_t *
+            {
+                return events + count;
+            };
+        };
+
         class EventSubscriber
         {
         public:
+            // Events of an encoded chunk decoded at once
+            static constexpr size_t DECODE_BATCH = 256;
+
             EventSubscriber(const EventSubscriber &rhs) = delete;
             EventSubscriber &operator=(const EventSubscriber &rhs) = delete;
 
             /**
              * @brief Constructor
              * @param app_name Application name
-             * @param pid Process ID
-             * @param tid Thread ID
+             * @param hart_id Hart ID
+             * @param wait_policy How to wait for chunks that did not arrive yet
              */
-            EventSubscriber(const std::string &app_name, const HartID_t &hart_id)
-                : m_app_name(app_name), m_hart_id(hart_id)
+            EventSubscriber(const std::string &app_name, const HartID_t &hart_id,
+                            const WaitPolicy_t &wait_policy = WaitPolicy_t{})
+                : m_app_name(app_name), m_hart_id(hart_id), m_waiter(wait_policy)
             {
                 // Configure subscriber options
                 iox::popo::SubscriberOptions subscriberOptions;
@@ -35,12 +82,9 @@ namespace archXplore
                 auto event_name_str = iox::into<iox::lossy<iox::capro::IdString_t>>(std::string("ThreadEvent"));
 
                 // Create subscriber
-                m_subscriber.reset(new iox::popo::Subscriber<Message_t>(
+                m_subscriber.reset(new iox::popo::UntypedSubscriber(
                     {app_name_str, instance_str, event_name_str}, subscriberOptions));
 
-                // Reset header to the beginning of the event buffer
-                m_event_buffer_header = m_event_buffer.begin();
-
                 init();
             }
 
@@ -68,64 +112,309 @@ namespace archXplore
              */
             auto shutdown() -> void
             {
+                releaseChunk();
+                m_waitset.reset();
                 m_subscriber->unsubscribe();
             };
 
             /**
-             * @brief Get front of event buffer
-             * @return Front of event buffer
+             * @brief Get the next contiguous run of ready events, taking a new chunk when needed
+             * @param max Maximum number of events
+             * @return Between 1 and max events, valid until the next call
+             *
+             * The events stay at the front of the buffer until they are released,
+             * a batch never spans two chunks.
+             */
+            inline auto nextBatch(const size_t &max) -> EventSpan_t
+            {
+                if (empty())
+                {
+                    nextChunk();
+                }
+                else if (m_next_chunk == nullptr && m_consumed >= m_prefetch_at)
+                {
+                    // Take the next chunk while the current one is still being consumed
+                    prefetchChunk();
+                }
+                if (m_chunk->encoding == EventEncoding_t::DELTA)
+                {
+                    if (m_decoded_pos == m_num_decoded)
+                    {
+                        decodeBatch();
+                    }
+                    return EventSpan_t{decoded() + m_decoded_pos, std::min(max, m_num_decoded - m_decoded_pos)};
+                }
+                return EventSpan_t{m_event_buffer_header, std::min<size_t>(max, m_event_buffer_end - m_event_buffer_header)};
+            };
+
+            /**
+             * @brief Get the next run of ready events on behalf of a fetch package
+             * @param max Maximum number of events
+             * @param package Package that may view events of earlier batches
+             * @return Between 1 and max events, valid until the next call
+             *
+             * Only the previous chunk outlives a chunk switch, so a package is
+             * detached before each switch. A package then never views a chunk
+             * returned to the publisher, however many chunks a block record
+             * chain spans.
+             */
+            inline auto nextBatch(const size_t &max, FetchPackage &package) -> EventSpan_t
+            {
+                if (empty())
+                {
+                    package.detach();
+                }
+                return nextBatch(max);
+            };
+
+            /**
+             * @brief Consume events from the front of the last batch
+             * @param count Number of consumed events, at most the size of the batch
              */
-            inline auto front() -> cpu::ThreadEvent_t &
+            inline auto release(const size_t &count) -> void
             {
-                if (m_event_buffer_header == m_event_buffer.end())
+                m_consumed += count;
+                if (m_chunk->encoding == EventEncoding_t::DELTA)
+                {
+                    m_decoded_pos += count;
+                }
+                else
                 {
-                    take();
+                    m_event_buffer_header += count;
                 }
-                return *m_event_buffer_header;
             };
 
             /**
-             * @brief Pop front of event buffer
+             * @brief Check whether events can be read without waiting
+             * @return True if the current or the next chunk holds events
              */
-            inline auto popFront() -> void
+            inline auto ready() -> bool
             {
-                m_event_buffer_header++;
+                return !empty() || m_next_chunk != nullptr || prefetchChunk();
             };
 
             /**
-             * @brief Take event buffer from subscriber
+             * @brief Notify the consumer whenever the publisher delivers a chunk
+             * @param listener Listener running the notification
+             * @param on_data Called on the thread of the listener
+             * @return True if the subscriber was attached, the listener may be full
+             *
+             * A subscriber notifies a single WaitSet or Listener, so once attached
+             * the blocking stage of waits is woken up by the listener too.
              */
-            inline auto take() -> void
+            inline auto attachListener(iox::popo::Listener &listener, std::function<void()> on_data) -> bool
             {
-                bool take_successful = false;
-                while (!take_successful)
+                // The WaitSet hands the notification over, it is created again when blocking without a listener
+                m_waitset.reset();
+                // The callback may run as soon as the subscriber is attached
+                m_on_data = std::move(on_data);
+                if (listener
+                        .attachEvent(*m_subscriber, iox::popo::SubscriberEvent::DATA_RECEIVED,
+                                     iox::popo::createNotificationCallback(onDataReceived, *this))
+                        .has_error())
                 {
-                    auto maybeEvent = m_subscriber->take();
-                    if (maybeEvent.has_value())
+                    m_on_data = nullptr;
+                    return false;
+                }
+                m_listening = true;
+                return true;
+            };
+
+            /**
+             * @brief Set how to wait for chunks that did not arrive yet
+             * @param wait_policy The policy
+             */
+            inline auto setWaitPolicy(const WaitPolicy_t &wait_policy) -> void
+            {
+                m_waiter.setPolicy(wait_policy);
+            };
+
+            /**
+             * @brief Get the time spent waiting for the publisher
+             * @return Wait statistics of every stage
+             */
+            inline auto getWaitStats() const -> const WaitStats_t &
+            {
+                return m_waiter.getStats();
+            };
+
+            /**
+             * @brief Check whether batches point into the received chunk
+             * @return True if events are read in place, false if they are decoded
+             */
+            inline auto inPlace() const -> bool
+            {
+                return m_chunk != nullptr && m_chunk->encoding != EventEncoding_t::DELTA;
+            };
+
+        private:
+            /**
+             * @brief Switch to the next chunk, waiting for the publisher if it was not prefetched
+             */
+            inline auto nextChunk() -> void
+            {
+                if (m_next_chunk == nullptr)
+                {
+                    // The wait shows up in the statistics instead of as hidden spin time
+                    m_waiter.wait([this]() { return prefetchChunk(); },
+                                  [this](const std::chrono::microseconds &timeout) { blockForData(timeout); });
+                }
+                // Events are read in place, the current chunk is kept until the next one is
+                // taken so a fetch group viewing it can still be consumed
+                releaseRetained();
+                m_retained_chunk = m_chunk;
+                m_chunk = m_next_chunk;
+                m_next_chunk = nullptr;
+                m_consumed = 0;
+                m_prefetch_at = m_chunk->num_events / 2;
+                if (m_chunk->encoding == EventEncoding_t::DELTA)
+                {
+                    // Events are decoded a batch at a time as they are consumed
+                    m_decoder.reset(m_chunk->bytes(), m_chunk->num_events);
+                    m_decoded_pos = m_num_decoded = 0;
+                }
+                else
+                {
+                    m_event_buffer_header = m_chunk->events();
+                    m_event_buffer_end = m_event_buffer_header + m_chunk->num_events;
+                }
+            };
+
+            /**
+             * @brief Try to take the next chunk from the subscriber
+             * @return True if the next chunk is available
+             */
+            inline auto prefetchChunk() -> bool
+            {
+                auto maybeChunk = m_subscriber->take();
+                if (maybeChunk.has_value())
+                {
+                    m_next_chunk = static_cast<const EventChunkHeader_t *>(maybeChunk.value());
+                    return true;
+                }
+                return false;
+            };
+
+            /**
+             * @brief Block until the publisher delivers a chunk
+             * @param timeout Longest time to block
+             */
+            inline auto blockForData(const std::chrono::microseconds &timeout) -> void
+            {
+                if (m_listening)
+                {
+                    std::unique_lock<std::mutex> lock(m_data_mutex);
+                    const uint64_t seen = m_data_signals;
+                    // A chunk delivered after the last poll but before the signal count was read
+                    if (m_subscriber->hasData())
+                    {
+                        return;
+                    }
+                    m_data_cv.wait_for(lock, timeout, [&]() { return m_data_signals != seen; });
+                    return;
+                }
+                // Only waiters that get to block need a condition variable of RouDi
+                if (m_waitset == nullptr && !m_waitset_failed)
+                {
+                    m_waitset = std::make_unique<iox::popo::WaitSet<>>();
+                    m_waitset->attachState(*m_subscriber, iox::popo::SubscriberState::HAS_DATA).or_else([this](auto)
+                    {
+                        m_waitset_failed = true;
+                    });
+                    if (m_waitset_failed)
                     {
-                        m_event_buffer = std::move(*maybeEvent.value());
-                        m_event_buffer_header = m_event_buffer.begin();
-                        take_successful = true;
+                        std::cerr << "Unable to attach the event subscriber of hart " << m_hart_id
+                                  << " to a WaitSet, it keeps yielding instead" << std::endl;
+                        m_waitset.reset();
                     }
                 }
+                if (__glibc_unlikely(m_waitset == nullptr))
+                {
+                    std::this_thread::yield();
+                    return;
+                }
+                m_waitset->timedWait(iox::units::Duration::fromMicroseconds(timeout.count()));
             };
 
             /**
-             * @brief Try to take event buffer from subscriber
-             * @return True if successful, false otherwise
+             * @brief Listener callback of a delivered chunk
+             * @param self The event subscriber owning the chunk
              */
-            inline auto tryTake() -> bool
+            static auto onDataReceived(iox::popo::UntypedSubscriber *const, EventSubscriber *const self) -> void
             {
-                auto maybeEvent = m_subscriber->take();
-                if (maybeEvent.has_value())
                 {
-                    m_event_buffer = std::move(*maybeEvent.value());
-                    m_event_buffer_header = m_event_buffer.begin();
+                    std::lock_guard<std::mutex> lock(self->m_data_mutex);
+                    self->m_data_signals++;
+                }
+                self->m_data_cv.notify_all();
+                self->m_on_data();
+            };
+
+            /**
+             * @brief Check whether all events of the current chunk were consumed
+             * @return True if no event is left
+             */
+            inline auto empty() const -> bool
+            {
+                if (m_chunk == nullptr)
+                {
                     return true;
                 }
-                else
+                if (m_chunk->encoding == EventEncoding_t::DELTA)
                 {
-                    return false;
+                    return m_decoded_pos == m_num_decoded && m_decoder.empty();
+                }
+                return m_event_buffer_header == m_event_buffer_end;
+            };
+
+            /**
+             * @brief Decode the next events of an encoded chunk into the batch buffer
+             */
+            inline auto decodeBatch() -> void
+            {
+                m_num_decoded = 0;
+                m_decoded_pos = 0;
+                while (m_num_decoded < DECODE_BATCH && !m_decoder.empty())
+                {
+                    std::memcpy(&m_decoded[m_num_decoded++], &m_decoder.current(), sizeof(cpu::ThreadEvent_t));
+                    m_decoder.next();
+                }
+            };
+
+            inline auto decoded() const -> const cpu::ThreadEvent_t *
+            {
+                return std::launder(reinterpret_cast<const cpu::ThreadEvent_t *>(m_decoded.get()));
+            };
+
+            /**
+             * @brief Return all held chunks to the publisher
+             */
+            inline auto releaseChunk() -> void
+            {
+                releaseRetained();
+                if (m_next_chunk != nullptr)
+                {
+                    m_subscriber->release(m_next_chunk);
+                    m_next_chunk = nullptr;
+                }
+                if (m_chunk != nullptr)
+                {
+                    m_subscriber->release(m_chunk);
+                    m_chunk = nullptr;
+                    m_event_buffer_header = nullptr;
+                    m_event_buffer_end = nullptr;
+                }
+            };
+
+            /**
+             * @brief Return the previous chunk to the publisher
+             */
+            inline auto releaseRetained() -> void
+            {
+                if (m_retained_chunk != nullptr)
+                {
+                    m_subscriber->release(m_retained_chunk);
+                    m_retained_chunk = nullptr;
                 }
             };
 
@@ -135,11 +424,42 @@ namespace archXplore
             // Hart ID
             const HartID_t m_hart_id;
             // Subscriber
-            std::unique_ptr<iox::popo::Subscriber<Message_t>> m_subscriber;
-            // Event buffer
-            Message_t m_event_buffer;
+            std::unique_ptr<iox::popo::UntypedSubscriber> m_subscriber;
+            // Chunk currently read
+            const EventChunkHeader_t *m_chunk = nullptr;
+            // Previous chunk, still referenced by the last fetch group
+            const EventChunkHeader_t *m_retained_chunk = nullptr;
+            // Chunk taken ahead of the consumer
+            const EventChunkHeader_t *m_next_chunk = nullptr;
+            // Events consumed from the current chunk
+            size_t m_consumed = 0;
+            // The next chunk is taken once this many events are consumed
+            size_t m_prefetch_at = 0;
+            // Waits for the publisher
+            AdaptiveWaiter m_waiter;
+            // Blocks until the publisher delivers a chunk
+            std::unique_ptr<iox::popo::WaitSet<>> m_waitset;
+            // The WaitSet could not be attached, blocking waits yield instead
+            bool m_waitset_failed = false;
+            // Notified by a listener when a chunk is delivered, replaces the WaitSet
+            std::function<void()> m_on_data;
+            bool m_listening = false;
+            std::mutex m_data_mutex;
+            std::condition_variable m_data_cv;
+            uint64_t m_data_signals = 0;
             // Header of the event buffer
-            Message_t::iterator m_event_buffer_header;
+            const cpu::ThreadEvent_t *m_event_buffer_header = nullptr;
+            // End of the event buffer
+            const cpu::ThreadEvent_t *m_event_buffer_end = nullptr;
+            // Decoder of an encoded chunk
+            EventDecoder m_decoder;
+            // Events decoded ahead of the consumer
+            std::unique_ptr<std::aligned_storage_t<sizeof(cpu::ThreadEvent_t), alignof(cpu::ThreadEvent_t)>[]> m_decoded{
+                new std::aligned_storage_t<sizeof(cpu::ThreadEvent_t), alignof(cpu::ThreadEvent_t)>[DECODE_BATCH]};
+            // Decoded events
+            size_t m_num_decoded = 0;
+            // Next decoded event to consume
+            size_t m_decoded_pos = 0;
         };
 
     } // namespace iss
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "cpu/StaticInst.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+
+        /**
+         * @brief View of the instructions of one fetch
+         *
+         * Instructions are spaced by a stride, so the view can point straight
+         * into an array of larger records holding one instruction each, such as
+         * the events of a received chunk. A view stays valid until the next
+         * fetch request to the ISS that returned it.
+         */
+        class FetchGroup_t
+        {
+        public:
+            class Iterator
+            {
+            public:
+                Iterator(const uint8_t *ptr, const size_t &stride) : m_ptr(ptr), m_stride(stride){};
+
+                inline auto operator*() const -> const cpu::StaticInst_t &
+                {
+                    return *reinterpret_cast<const cpu::StaticInst_t *>(m_ptr);
+                };
+
+                inline auto operator->() const -> const cpu::StaticInst_t *
+                {
+                    return reinterpret_cast<const cpu::StaticInst_t *>(m_ptr);
+                };
+
+                inline auto operator++() -> Iterator &
+                {
+                    m_ptr += m_stride;
+                    return *this;
+                };
+
+                inline auto operator==(const Iterator &rhs) const -> bool
+                {
+                    return m_ptr == rhs.m_ptr;
+                };
+
+                inline auto operator!=(const Iterator &rhs) const -> bool
+                {
+                    return m_ptr != rhs.m_ptr;
+                };
+
+            private:
+                const uint8_t *m_ptr;
+                size_t m_stride;
+            };
+
+            FetchGroup_t() = default;
+
+            /**
+             * @brief Constructor
+             * @param first First instruction
+             * @param count Number of instructions
+             * @param stride Distance between two instructions in bytes
+             */
+            FetchGroup_t(const cpu::StaticInst_t *first, const size_t &count, const size_t &stride = sizeof(cpu::StaticInst_t))
+                : m_first(reinterpret_cast<const uint8_t *>(first)), m_count(count), m_stride(stride){};
+
+            inline auto size() const -> size_t
+            {
+                return m_count;
+            };
+
+            inline auto empty() const -> bool
+            {
+                return m_count == 0;
+            };
+
+            inline auto operator[](const size_t &index) const -> const cpu::StaticInst_t &
+            {
+                return *reinterpret_cast<const cpu::StaticInst_t *>(m_first + index * m_stride);
+            };
+
+            inline auto begin() const -> Iterator
+            {
+                return Iterator(m_first, m_stride);
+            };
+
+            inline auto end() const -> Iterator
+            {
+                return Iterator(m_first + m_count * m_stride, m_stride);
+            };
+
+        private:
+            // First instruction
+            const uint8_t *m_first = nullptr;
+            // Number of instructions
+            size_t m_count = 0;
+            // Distance between two instructions in bytes
+            size_t m_stride = sizeof(cpu::StaticInst_t);
+        };
+
+        /**
+         * @brief Builds the instruction group of one fetch
+         *
+         * Instructions appended in place are only referenced while they are
+         * consecutive in their source array. The package falls back to its own
+         * storage, whose capacity is kept across fetches, when they are not or
+         * when the source is about to be overwritten.
+         */
+        class FetchPackage
+        {
+        public:
+            FetchPackage()
+            {
+                m_storage.reserve(64);
+            };
+
+            /**
+             * @brief Start a new package, views of the previous one become invalid
+             *
+             * @return void
+             */
+            inline auto reset() -> void
+            {
+                m_first = nullptr;
+                m_count = 0;
+                m_detached = false;
+                m_storage.clear();
+            };
+
+            /**
+             * @brief Append an instruction that stays in place until the package is consumed
+             * @param inst The instruction
+             * @param stride Distance to the next instruction of its source array in bytes
+             *
+             * @return void
+             */
+            inline auto append(const cpu::StaticInst_t &inst, const size_t &stride = sizeof(cpu::StaticInst_t)) -> void
+            {
+                auto ptr = reinterpret_cast<const uint8_t *>(&inst);
+                if (__glibc_likely(!m_detached))
+                {
+                    if (m_count == 0)
+                    {
+                        m_first = ptr;
+                        m_stride = stride;
+                        m_count = 1;
+                        return;
+                    }
+                    if (__glibc_likely(stride == m_stride && ptr == m_first + m_count * m_stride))
+                    {
+                        m_count++;
+                        return;
+                    }
+                    detach();
+                }
+                m_storage.emplace_back(inst);
+            };
+
+            /**
+             * @brief Append a copy of an instruction whose storage is reused
+             * @param inst The instruction
+             *
+             * @return void
+             */
+            inline auto copy(const cpu::StaticInst_t &inst) -> void
+            {
+                if (!m_detached)
+                {
+                    detach();
+                }
+                m_storage.emplace_back(inst);
+            };
+
+            /**
+             * @brief Copy the referenced instructions, before their source goes away
+             *
+             * @return void
+             */
+            inline auto detach() -> void
+            {
+                if (m_detached)
+                {
+                    return;
+                }
+                for (size_t i = 0; i < m_count; ++i)
+                {
+                    m_storage.emplace_back(*reinterpret_cast<const cpu::StaticInst_t *>(m_first + i * m_stride));
+                }
+                m_detached = true;
+            };
+
+            /**
+             * @brief Get the view of the package
+             * @return The instructions of the package
+             */
+            inline auto group() const -> FetchGroup_t
+            {
+                if (m_detached)
+                {
+                    return FetchGroup_t(m_storage.data(), m_storage.size());
+                }
+                return FetchGroup_t(reinterpret_cast<const cpu::StaticInst_t *>(m_first), m_count, m_stride);
+            };
+
+        private:
+            // Referenced instructions
+            const uint8_t *m_first = nullptr;
+            size_t m_count = 0;
+            size_t m_stride = sizeof(cpu::StaticInst_t);
+            // The package lives in its own storage
+            bool m_detached = false;
+            // Copied instructions
+            std::vector<cpu::StaticInst_t> m_storage;
+        };
+
+    } // namespace iss
+} // namespace archXplore
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+#include "iss/IPCConfig.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+
+        /*
+         * @brief Decisions taken by a flush policy
+         */
+        struct FlushStats_t
+        {
+            // Chunks published because the batch size was reached
+            uint64_t batch_flushes = 0;
+            // Chunks published because the latency bound expired
+            uint64_t deadline_flushes = 0;
+            // Chunks published on request of the caller
+            uint64_t forced_flushes = 0;
+            // Publishes that had to wait for the consumer
+            uint64_t stalls = 0;
+            // Batch size increases
+            uint64_t batch_grows = 0;
+            // Batch size decreases
+            uint64_t batch_shrinks = 0;
+            // Events published
+            uint64_t events = 0;
+            // Current batch size
+            size_t batch_size = 0;
+        };
+
+        /**
+         * @brief Adaptive batch size of a single event stream
+         *
+         * A chunk is published once it holds the current batch size or once its
+         * oldest event is older than the latency bound. Publishes that have to wait
+         * for the consumer, and batches filled well within the bound, grow the
+         * batch toward the chunk capacity to amortize the publish cost. Chunks
+         * closed by the deadline or by the caller shrink the batch to what the
+         * stream actually produced, so the next chunk is loaned from a smaller
+         * size class. The host clock is read on the first event of a chunk and
+         * the interval between two reads doubles up to CLOCK_CHECK_INTERVAL events
+         * while the stream stays dense, so a sparse stream reads it on every event
+         * and still meets the bound.
+         */
+        class FlushPolicy
+        {
+        public:
+            // Smallest batch size
+            static constexpr size_t MIN_BATCH_SIZE = 256;
+
+            // Largest number of events between two checks of the host clock
+            static constexpr size_t CLOCK_CHECK_INTERVAL = 256;
+
+            // Publish time above which the consumer is considered behind
+            static constexpr std::chrono::microseconds STALL_THRESHOLD{50};
+
+            /**
+             * @brief Constructor
+             * @param latency Latency bound of a buffered event, zero disables the bound
+             * @param capacity Capacity of a chunk
+             */
+            FlushPolicy(const std::chrono::microseconds &latency = std::chrono::microseconds(1000),
+                        const size_t &capacity = MESSAGE_VECTOR_SIZE)
+                : m_latency(latency), m_capacity(capacity)
+            {
+                m_stats.batch_size = m_capacity;
+            };
+
+            /**
+             * @brief Check whether the chunk should be published after adding an event
+             * @param num_events Number of events in the chunk
+             * @return True if the chunk should be published
+             */
+            inline auto shouldFlush(const size_t &num_events) -> bool
+            {
+                if (num_events == 1)
+                {
+                    m_chunk_start = std::chrono::steady_clock::now();
+                    m_last_check = m_chunk_start;
+                    // The next event checks the clock again
+                    m_check_interval = 1;
+                    m_check_countdown = 2;
+                }
+                if (num_events >= m_stats.batch_size)
+                {
+                    // The stream got busy again
+                    if (m_stats.batch_size < m_capacity && m_latency.count() > 0 &&
+                        std::chrono::steady_clock::now() - m_chunk_start < m_latency / 4)
+                    {
+                        grow();
+                    }
+                    m_stats.batch_flushes++;
+                    return true;
+                }
+                if (m_latency.count() > 0 && --m_check_countdown == 0 && deadlineExpired())
+                {
+                    // Publish what the stream produces within the bound next time
+                    shrink(num_events);
+                    m_stats.deadline_flushes++;
+                    return true;
+                }
+                return false;
+            };
+
+            /**
+             * @brief Record a forced publish
+             * @param num_events Number of events in the chunk
+             *
+             * @return void
+             */
+            inline auto forced(const size_t &num_events) -> void
+            {
+                m_stats.forced_flushes++;
+                // Streams cut short by the caller do not need large chunks
+                shrink(num_events);
+            };
+
+            /**
+             * @brief Record a published chunk
+             * @param num_events Number of events in the chunk
+             * @param elapsed Time spent publishing the chunk and loaning the next one
+             *
+             * @return void
+             */
+            inline auto published(const size_t &num_events, const std::chrono::steady_clock::duration &elapsed) -> void
+            {
+                m_stats.events += num_events;
+                if (elapsed >= STALL_THRESHOLD)
+                {
+                    m_stats.stalls++;
+                    // The consumer is behind, larger batches cost it less
+                    if (m_stats.batch_size < m_capacity)
+                    {
+                        grow();
+                    }
+                }
+            };
+
+            /**
+             * @brief Get the decisions taken so far
+             * @return Flush statistics
+             */
+            inline auto getStats() const -> const FlushStats_t &
+            {
+                return m_stats;
+            };
+
+        private:
+            /**
+             * @brief Read the host clock and adapt the interval to the next read
+             * @return True if the oldest event of the chunk is older than the latency bound
+             */
+            inline auto deadlineExpired() -> bool
+            {
+                const auto now = std::chrono::steady_clock::now();
+                // Double the interval while it would still take well within the bound
+                if ((now - m_last_check) * 2 < m_latency / 4)
+                {
+                    m_check_interval = std::min(CLOCK_CHECK_INTERVAL, m_check_interval * 2);
+                }
+                else
+                {
+                    m_check_interval = 1;
+                }
+                m_check_countdown = m_check_interval;
+                m_last_check = now;
+                return now - m_chunk_start >= m_latency;
+            };
+
+            /**
+             * @brief Double the batch size up to the chunk capacity
+             *
+             * @return void
+             */
+            inline auto grow() -> void
+            {
+                m_stats.batch_size = std::min(m_capacity, m_stats.batch_size * 2);
+                m_stats.batch_grows++;
+            };
+
+            /**
+             * @brief Lower the batch size to the given number of events
+             * @param num_events Number of events
+             *
+             * @return void
+             */
+            inline auto shrink(const size_t &num_events) -> void
+            {
+                const size_t batch_size = std::max(MIN_BATCH_SIZE, num_events);
+                if (batch_size < m_stats.batch_size)
+                {
+                    m_stats.batch_size = batch_size;
+                    m_stats.batch_shrinks++;
+                }
+            };
+
+        private:
+            // Latency bound of a buffered event
+            const std::chrono::microseconds m_latency;
+            // Capacity of a chunk
+            const size_t m_capacity;
+            // Time the first event of the current chunk was added
+            std::chrono::steady_clock::time_point m_chunk_start;
+            // Time of the last clock check
+            std::chrono::steady_clock::time_point m_last_check;
+            // Events between two clock checks, one for sparse streams
+            size_t m_check_interval = 1;
+            // Events left until the next clock check
+            size_t m_check_countdown = 1;
+            // Decisions
+            FlushStats_t m_stats;
+        };
+
+    } // namespace iss
+
+} // namespace archXplore
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "iceoryx_hoofs/cxx/vector.hpp"
+#include <array>
 
 #include "cpu/ThreadEvent.hpp"
 
@@ -15,9 +15,105 @@ namespace archXplore
 
         constexpr size_t MESSAGE_BUFFER_SIZE = 4;
 
-        typedef iox::cxx::vector<cpu::ThreadEvent_t, MESSAGE_VECTOR_SIZE> Message_t;
+        /*
+         * @brief Payload encoding of an event chunk
+         */
+        enum class EventEncoding_t : uint8_t
+        {
+            RAW,  // Array of ThreadEvent_t
+            DELTA // Delta/varint coded byte stream, see EventEncoder
+        };
 
-        constexpr size_t MESSAGE_CHUNK_SIZE = sizeof(Message_t);
+        /*
+         * @brief Header of a variable-length event chunk, the events follow it
+         */
+        struct alignas(alignof(cpu::ThreadEvent_t)) EventChunkHeader_t
+        {
+            // Number of events in the chunk
+            uint32_t num_events;
+            // Number of events the chunk can hold without encoding
+            uint32_t capacity;
+            // Number of payload bytes used by an encoded chunk
+            uint32_t num_bytes;
+            // Payload encoding
+            EventEncoding_t encoding;
+
+            inline auto events() -> cpu::ThreadEvent_t *
+            {
+                return reinterpret_cast<cpu::ThreadEvent_t *>(this + 1);
+            };
+
+            inline auto events() const -> const cpu::ThreadEvent_t *
+            {
+                return reinterpret_cast<const cpu::ThreadEvent_t *>(this + 1);
+            };
+
+            inline auto bytes() -> uint8_t *
+            {
+                return reinterpret_cast<uint8_t *>(this + 1);
+            };
+
+            inline auto bytes() const -> const uint8_t *
+            {
+                return reinterpret_cast<const uint8_t *>(this + 1);
+            };
+        };
+
+        /**
+         * @brief Payload size of an event chunk
+         * @param capacity Number of events the chunk can hold
+         * @return Payload size in bytes
+         */
+        constexpr auto eventChunkSize(const size_t &capacity) -> size_t
+        {
+            return sizeof(EventChunkHeader_t) + capacity * sizeof(cpu::ThreadEvent_t);
+        }
+
+        /*
+         * @brief Mempool size class of event chunks
+         */
+        struct EventChunkClass_t
+        {
+            // Number of events a chunk holds
+            size_t capacity;
+            // Number of chunks in the mempool
+            size_t num_chunks;
+        };
+
+        // Ascending size classes, most traffic goes through the small ones
+        constexpr std::array<EventChunkClass_t, 4> EVENT_CHUNK_CLASSES{{
+            {256, MAX_HARTS * MESSAGE_BUFFER_SIZE * 3},
+            {1024, MAX_HARTS * MESSAGE_BUFFER_SIZE * 3},
+            {4096, MAX_HARTS * MESSAGE_BUFFER_SIZE},
+            {MESSAGE_VECTOR_SIZE, MAX_HARTS},
+        }};
+
+        // Per-hart dynamic event stream
+        constexpr const char *THREAD_EVENT_SERVICE = "ThreadEvent";
+
+        // Per-process static code definitions
+        constexpr const char *STATIC_CODE_SERVICE = "StaticCode";
+
+        // Per-process control requests from the simulator
+        constexpr const char *CONTROL_SERVICE = "Control";
+
+        /*
+         * @brief Instrumentation level of a QEMU process
+         */
+        enum class InstrumentMode_t : uint8_t
+        {
+            NONE,  // No instrumentation
+            COUNT, // Inline instruction counters only
+            FULL   // Full event stream
+        };
+
+        struct ControlMessage_t
+        {
+            // Requested instrumentation mode
+            InstrumentMode_t mode;
+            // Instructions to run in the requested mode before returning to the previous one, zero keeps it
+            uint64_t budget;
+        };
 
     } // namespace iss
 
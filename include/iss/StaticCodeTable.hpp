@@ -0,0 +1,263 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "sparta/utils/SpartaAssert.hpp"
+
+#include "iceoryx_posh/popo/untyped_subscriber.hpp"
+#include "iceoryx_posh/popo/listener.hpp"
+
+#include "iss/IPCConfig.hpp"
+#include "iss/WaitPolicy.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+
+        class StaticCodeTable
+        {
+        public:
+            // Longest wait for a definition, the QEMU process flushes it before the block first executes
+            static constexpr std::chrono::seconds DEFINITION_TIMEOUT{10};
+
+            // Polls between two checks of the definition timeout
+            static constexpr uint32_t TIMEOUT_CHECK_MASK = 1023;
+
+            /*
+             * @brief Static instructions of a translated block
+             */
+            struct Block_t
+            {
+                BlockID_t id;
+                Addr_t pc;
+                std::vector<cpu::StaticInst_t> insts;
+            };
+
+            StaticCodeTable(const StaticCodeTable &rhs) = delete;
+            StaticCodeTable &operator=(const StaticCodeTable &rhs) = delete;
+
+            /**
+             * @brief Constructor
+             * @param app_name Application name
+             * @param pid Process ID of the QEMU process publishing the definitions
+             */
+            StaticCodeTable(const std::string &app_name, const ProcessID_t &pid)
+                : m_app_name(app_name), m_pid(pid), m_pages(new std::atomic<Page_t *>[MAX_PAGES])
+            {
+                for (size_t i = 0; i < MAX_PAGES; ++i)
+                {
+                    m_pages[i].store(nullptr, std::memory_order_relaxed);
+                }
+
+                // Configure subscriber options
+                iox::popo::SubscriberOptions subscriberOptions;
+                subscriberOptions.queueCapacity = MESSAGE_BUFFER_SIZE;
+                subscriberOptions.historyRequest = 0;
+                subscriberOptions.queueFullPolicy = iox::popo::QueueFullPolicy::BLOCK_PRODUCER;
+
+                auto app_name_str = iox::into<iox::lossy<iox::capro::IdString_t>>(app_name);
+                auto instance_str = iox::into<iox::lossy<iox::capro::IdString_t>>(std::to_string(pid));
+                auto event_name_str = iox::into<iox::lossy<iox::capro::IdString_t>>(std::string(STATIC_CODE_SERVICE));
+
+                // Create subscriber
+                m_subscriber.reset(new iox::popo::UntypedSubscriber(
+                    {app_name_str, instance_str, event_name_str}, subscriberOptions));
+
+                // Definitions are drained by the listener thread as soon as they arrive
+                m_listener.attachEvent(*m_subscriber, iox::popo::SubscriberEvent::DATA_RECEIVED,
+                                       iox::popo::createNotificationCallback(onStaticCodeReceived, *this))
+                    .or_else([](auto)
+                             { throw std::runtime_error("Unable to attach static code subscriber"); });
+            };
+
+            /**
+             * @brief Destructor
+             */
+            ~StaticCodeTable()
+            {
+                m_listener.detachEvent(*m_subscriber, iox::popo::SubscriberEvent::DATA_RECEIVED);
+                m_subscriber->unsubscribe();
+            };
+
+            /**
+             * @brief Look up a block, lock-free
+             * @param id Block ID
+             * @return Pointer to the block, nullptr if it was not received yet
+             */
+            inline auto find(const BlockID_t &id) const -> const Block_t *
+            {
+                const size_t page_index = id / PAGE_SIZE;
+                if (page_index >= MAX_PAGES)
+                {
+                    return nullptr;
+                }
+                const Page_t *page = m_pages[page_index].load(std::memory_order_acquire);
+                if (page == nullptr)
+                {
+                    return nullptr;
+                }
+                return (*page)[id % PAGE_SIZE].load(std::memory_order_acquire);
+            };
+
+            /**
+             * @brief Look up a block, waiting until its definition arrives
+             *
+             * A definition missing for DEFINITION_TIMEOUT means the QEMU process is gone.
+             * @param id Block ID
+             * @param waiter Waiter of the hart, following the wait policy of its process
+             * @return Reference to the block
+             */
+            inline auto wait(const BlockID_t &id, AdaptiveWaiter &waiter) const -> const Block_t &
+            {
+                const Block_t *block = nullptr;
+                uint32_t polls = 0;
+                std::chrono::steady_clock::time_point deadline;
+                waiter.wait(
+                    [&]()
+                    {
+                        block = find(id);
+                        if (__glibc_unlikely(block == nullptr && (polls++ & TIMEOUT_CHECK_MASK) == 0))
+                        {
+                            const auto now = std::chrono::steady_clock::now();
+                            if (polls == 1)
+                            {
+                                deadline = now + DEFINITION_TIMEOUT;
+                            }
+                            sparta_assert(now < deadline, "Definition of block " << id << " of process " << m_pid
+                                                                                 << " did not arrive");
+                        }
+                        return block != nullptr;
+                    },
+                    [&](const std::chrono::microseconds &timeout)
+                    {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        m_cond.wait_for(lock, timeout, [&]() { return find(id) != nullptr; });
+                    });
+                return *block;
+            };
+
+        private:
+            static constexpr size_t PAGE_SIZE = 4096;
+
+            static constexpr size_t MAX_PAGES = 65536;
+
+            typedef std::array<std::atomic<const Block_t *>, PAGE_SIZE> Page_t;
+
+            /**
+             * @brief Drain all available definitions, called by the listener thread
+             * @param subscriber Static code subscriber
+             * @param self Table to fill
+             */
+            static auto onStaticCodeReceived(iox::popo::UntypedSubscriber *subscriber, StaticCodeTable *self) -> void
+            {
+                bool take_successful = true;
+                while (take_successful)
+                {
+                    auto maybeChunk = subscriber->take();
+                    take_successful = maybeChunk.has_value();
+                    if (take_successful)
+                    {
+                        auto chunk = static_cast<const EventChunkHeader_t *>(maybeChunk.value());
+                        for (uint32_t i = 0; i < chunk->num_events; ++i)
+                        {
+                            self->receive(chunk->events()[i]);
+                        }
+                        subscriber->release(maybeChunk.value());
+                    }
+                }
+            };
+
+            /**
+             * @brief Receive a definition event
+             * @param ev Block definition or one of its instructions
+             */
+            auto receive(const cpu::ThreadEvent_t &ev) -> void
+            {
+                if (ev.tag == cpu::ThreadEvent_t::Tag::BLOCK_DEFINE)
+                {
+                    m_partial.id = ev.block_define.block_id;
+                    m_partial.pc = ev.block_define.pc;
+                    m_partial.insts.clear();
+                    m_partial.insts.reserve(ev.block_define.num_insts);
+                    m_partial_remaining = ev.block_define.num_insts;
+                }
+                else if (ev.tag == cpu::ThreadEvent_t::Tag::INSTRUCTION && m_partial_remaining > 0)
+                {
+                    m_partial.insts.emplace_back(ev.instruction);
+                    m_partial_remaining--;
+                }
+                else
+                {
+                    return;
+                }
+                if (m_partial_remaining == 0)
+                {
+                    insert();
+                }
+            };
+
+            /**
+             * @brief Publish the completed block to readers
+             */
+            auto insert() -> void
+            {
+                const BlockID_t id = m_partial.id;
+                const size_t page_index = id / PAGE_SIZE;
+                if (page_index >= MAX_PAGES)
+                {
+                    throw std::runtime_error("Static code table is full");
+                }
+                m_blocks.emplace_back(std::move(m_partial));
+                m_partial = Block_t();
+                Page_t *page = m_pages[page_index].load(std::memory_order_relaxed);
+                if (page == nullptr)
+                {
+                    m_page_storage.emplace_back(new Page_t());
+                    page = m_page_storage.back().get();
+                    for (auto &entry : *page)
+                    {
+                        entry.store(nullptr, std::memory_order_relaxed);
+                    }
+                    m_pages[page_index].store(page, std::memory_order_release);
+                }
+                (*page)[id % PAGE_SIZE].store(&m_blocks.back(), std::memory_order_release);
+                // Blocked harts check the table under the lock
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                }
+                m_cond.notify_all();
+            };
+
+        private:
+            // Application name
+            const std::string m_app_name;
+            // Process ID
+            const ProcessID_t m_pid;
+            // Page directory indexed by block ID
+            std::unique_ptr<std::atomic<Page_t *>[]> m_pages;
+            // Page storage
+            std::vector<std::unique_ptr<Page_t>> m_page_storage;
+            // Block storage, addresses stay valid on growth
+            std::deque<Block_t> m_blocks;
+            // Block currently being received
+            Block_t m_partial;
+            // Instructions missing from the block being received
+            size_t m_partial_remaining = 0;
+            // Subscriber
+            std::unique_ptr<iox::popo::UntypedSubscriber> m_subscriber;
+            // Listener running the drain callback
+            iox::popo::Listener m_listener;
+            // Wakes up harts blocked on a missing definition
+            mutable std::mutex m_mutex;
+            mutable std::condition_variable m_cond;
+        };
+
+    } // namespace iss
+
+} // namespace archXplore
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstring>
+
+#include "iss/IPCConfig.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+        /*
+         * Binary trace file layout
+         *
+         *   TraceFileHeader_t
+         *   { TraceChunkHeader_t, num_bytes of payload } ...
+         *   TraceIndexEntry_t ...
+         *   TraceFooter_t
+         *
+         * Chunks of all harts are interleaved in the order they were filled. The
+         * events of one hart appear in program order across its chunks. Every
+         * payload can be decoded on its own, so the index of all chunks at the end
+         * of the file is enough to start decoding a hart at any of them. A trace
+         * whose recording was killed has no index and is read front to back.
+         *
+         * Payloads are delta encoded like the event stream, they are not compressed
+         * any further.
+         */
+
+        constexpr char TRACE_MAGIC[8] = {'A', 'X', 'T', 'R', 'A', 'C', 'E', '\0'};
+
+        constexpr char TRACE_INDEX_MAGIC[8] = {'A', 'X', 'I', 'N', 'D', 'E', 'X', '\0'};
+
+        // Version 2 appends the chunk index
+        constexpr uint32_t TRACE_VERSION = 2;
+
+        // Payload bytes of a trace chunk
+        constexpr size_t TRACE_CHUNK_SIZE = 1 << 20;
+
+        /*
+         * @brief Header at the beginning of a trace file
+         */
+        struct TraceFileHeader_t
+        {
+            // File magic, TRACE_MAGIC
+            char magic[8];
+            // Format version, TRACE_VERSION
+            uint32_t version;
+            // Number of harts of the traced process
+            uint16_t num_harts;
+            // Encoding of the chunk payloads
+            EventEncoding_t encoding;
+            uint8_t reserved;
+
+            /**
+             * @brief Check magic and version
+             * @return True if the file is a supported trace
+             */
+            inline auto valid() const -> bool
+            {
+                return std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0 && version >= 1 && version <= TRACE_VERSION;
+            };
+        };
+
+        /*
+         * @brief Header in front of every chunk payload
+         */
+        struct TraceChunkHeader_t
+        {
+            // Event ID of the first event in the chunk
+            EventID_t first_event_id;
+            // Number of events in the chunk
+            uint32_t num_events;
+            // Number of payload bytes
+            uint32_t num_bytes;
+            // Hart index within the traced process
+            HartID_t hart_index;
+            uint8_t reserved[6];
+        };
+
+        /*
+         * @brief Index entry of a chunk
+         */
+        struct TraceIndexEntry_t
+        {
+            // File offset of the chunk header
+            uint64_t offset;
+            // Instructions of the hart before the chunk
+            uint64_t inst_count;
+            // Event ID of the first event in the chunk
+            EventID_t first_event_id;
+            // Hart index within the traced process
+            HartID_t hart_index;
+            uint8_t reserved[6];
+        };
+
+        /*
+         * @brief Footer at the end of an indexed trace file
+         */
+        struct TraceFooter_t
+        {
+            // File offset of the first index entry
+            uint64_t index_offset;
+            // Number of index entries, one per chunk
+            uint64_t num_entries;
+            // Index magic, TRACE_INDEX_MAGIC
+            char magic[8];
+
+            /**
+             * @brief Check the index magic
+             * @return True if the footer closes an index
+             */
+            inline auto valid() const -> bool
+            {
+                return std::memcmp(magic, TRACE_INDEX_MAGIC, sizeof(magic)) == 0;
+            };
+        };
+
+    } // namespace iss
+
+} // namespace archXplore
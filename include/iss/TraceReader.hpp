@@ -0,0 +1,426 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sparta/utils/SpartaAssert.hpp"
+
+#include "iss/EventCodec.hpp"
+#include "iss/TraceFormat.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+
+        /**
+         * @brief Read-only memory mapping of a trace file
+         *
+         * The file is mapped once and shared by all harts replaying it. Opening
+         * reads the chunk index at the end of the file, or walks the chunk headers
+         * of a trace without index, to find the chunks of every hart. Payloads are
+         * paged in by the kernel when a hart reaches them.
+         */
+        class TraceReader
+        {
+        public:
+            TraceReader(const TraceReader &rhs) = delete;
+            TraceReader &operator=(const TraceReader &rhs) = delete;
+
+            /**
+             * @brief Constructor
+             * @param path Path of the trace file
+             */
+            TraceReader(const std::string &path) : m_path(path)
+            {
+                int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0)
+                {
+                    throw std::runtime_error("Unable to open trace file " + path);
+                }
+                struct stat st;
+                if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(TraceFileHeader_t))
+                {
+                    ::close(fd);
+                    throw std::runtime_error("Trace file " + path + " is truncated");
+                }
+                m_size = st.st_size;
+                void *base = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                // The mapping keeps the file referenced
+                ::close(fd);
+                if (base == MAP_FAILED)
+                {
+                    throw std::runtime_error("Unable to map trace file " + path);
+                }
+                m_base = static_cast<const uint8_t *>(base);
+                // Harts walk the file front to back, let the kernel read ahead aggressively
+                ::madvise(base, m_size, MADV_SEQUENTIAL);
+                if (!header().valid() || header().encoding != EventEncoding_t::DELTA)
+                {
+                    unmap();
+                    throw std::runtime_error(path + " is not a supported trace file");
+                }
+                buildChunkList();
+            };
+
+            /**
+             * @brief Destructor
+             */
+            ~TraceReader()
+            {
+                unmap();
+            };
+
+            /**
+             * @brief Get the file header
+             * @return The file header
+             */
+            inline auto header() const -> const TraceFileHeader_t &
+            {
+                return *reinterpret_cast<const TraceFileHeader_t *>(m_base);
+            };
+
+            /**
+             * @brief Get the number of harts of the traced process
+             * @return Number of harts
+             */
+            inline auto getNumHarts() const -> HartID_t
+            {
+                return header().num_harts;
+            };
+
+            /**
+             * @brief Get the chunks of a hart
+             * @param hart_index Hart index within the traced process
+             * @return Chunk headers in program order
+             */
+            inline auto getChunks(const HartID_t &hart_index) const -> const std::vector<const TraceChunkHeader_t *> &
+            {
+                sparta_assert(hart_index < m_chunks.size(), "Trace " << m_path << " has no hart " << hart_index);
+                return m_chunks[hart_index];
+            };
+
+            /**
+             * @brief Check whether the chunks carry instruction counts
+             * @return True if the file has a chunk index
+             */
+            inline auto hasIndex() const -> bool
+            {
+                return m_has_index;
+            };
+
+            /**
+             * @brief Find the chunk holding an instruction
+             * @param hart_index Hart index within the traced process
+             * @param inst_count Instructions of the hart before the instruction
+             * @return Index of the last chunk starting at or before the instruction,
+             *         the first chunk when the file has no index
+             */
+            inline auto findChunk(const HartID_t &hart_index, const uint64_t &inst_count) const -> size_t
+            {
+                if (!m_has_index || m_chunks[hart_index].empty())
+                {
+                    return 0;
+                }
+                const auto &counts = m_inst_counts[hart_index];
+                auto it = std::upper_bound(counts.begin(), counts.end(), inst_count);
+                return it == counts.begin() ? 0 : std::distance(counts.begin(), it) - 1;
+            };
+
+            /**
+             * @brief Get the instructions of a hart before a chunk
+             * @param hart_index Hart index within the traced process
+             * @param chunk_index Index of the chunk in the chunk list of the hart
+             * @return Instruction count, zero for the first chunk of a file without index
+             */
+            inline auto getInstCount(const HartID_t &hart_index, const size_t &chunk_index) const -> uint64_t
+            {
+                return m_has_index ? m_inst_counts[hart_index][chunk_index] : 0;
+            };
+
+            /**
+             * @brief Count the instructions of a hart
+             * @param hart_index Hart index within the traced process
+             * @return Number of instructions in the trace of the hart
+             *
+             * Only the last chunk of the hart is decoded.
+             */
+            auto getTotalInstCount(const HartID_t &hart_index) const -> uint64_t
+            {
+                sparta_assert(m_has_index, "Trace " << m_path << " has no index to count instructions");
+                const auto &chunks = getChunks(hart_index);
+                if (chunks.empty())
+                {
+                    return 0;
+                }
+                uint64_t inst_count = m_inst_counts[hart_index].back();
+                EventDecoder decoder;
+                for (decoder.reset(payload(chunks.back()), chunks.back()->num_events); !decoder.empty(); decoder.next())
+                {
+                    if (decoder.current().tag == cpu::ThreadEvent_t::InsnTag)
+                    {
+                        inst_count++;
+                    }
+                }
+                return inst_count;
+            };
+
+            /**
+             * @brief Get the payload of a chunk
+             * @param chunk The chunk header
+             * @return Pointer to the first payload byte
+             */
+            static inline auto payload(const TraceChunkHeader_t *chunk) -> const uint8_t *
+            {
+                return reinterpret_cast<const uint8_t *>(chunk + 1);
+            };
+
+            /**
+             * @brief Hint that a chunk is about to be decoded
+             * @param chunk The chunk header
+             *
+             * @return void
+             */
+            inline auto willNeed(const TraceChunkHeader_t *chunk) const -> void
+            {
+                advise(chunk, MADV_WILLNEED);
+            };
+
+            /**
+             * @brief Hint that a chunk has been decoded and won't be read again
+             * @param chunk The chunk header
+             *
+             * @return void
+             */
+            inline auto dontNeed(const TraceChunkHeader_t *chunk) const -> void
+            {
+                // Pages stay in the page cache, only this process drops them
+                advise(chunk, MADV_DONTNEED);
+            };
+
+        private:
+            /**
+             * @brief Sort chunks by hart
+             *
+             * @return void
+             */
+            auto buildChunkList() -> void
+            {
+                m_chunks.resize(getNumHarts());
+                m_inst_counts.resize(getNumHarts());
+                if (header().version >= 2 && readIndex())
+                {
+                    return;
+                }
+                scanChunks();
+            };
+
+            /**
+             * @brief Read the chunk index without touching any chunk
+             * @return False if the file ends without a complete index
+             */
+            auto readIndex() -> bool
+            {
+                if (m_size < sizeof(TraceFileHeader_t) + sizeof(TraceFooter_t))
+                {
+                    return false;
+                }
+                auto footer = reinterpret_cast<const TraceFooter_t *>(m_base + m_size - sizeof(TraceFooter_t));
+                if (!footer->valid() || footer->index_offset < sizeof(TraceFileHeader_t) ||
+                    footer->index_offset + footer->num_entries * sizeof(TraceIndexEntry_t) + sizeof(TraceFooter_t) != m_size)
+                {
+                    return false;
+                }
+                auto entries = reinterpret_cast<const TraceIndexEntry_t *>(m_base + footer->index_offset);
+                for (uint64_t i = 0; i < footer->num_entries; ++i)
+                {
+                    const auto &entry = entries[i];
+                    sparta_assert(entry.hart_index < m_chunks.size() && entry.offset < footer->index_offset,
+                                  "Trace " << m_path << " has a broken index entry " << i);
+                    m_chunks[entry.hart_index].push_back(reinterpret_cast<const TraceChunkHeader_t *>(m_base + entry.offset));
+                    m_inst_counts[entry.hart_index].push_back(entry.inst_count);
+                }
+                m_has_index = true;
+                return true;
+            };
+
+            /**
+             * @brief Walk the chunk headers of a trace without index
+             *
+             * @return void
+             */
+            auto scanChunks() -> void
+            {
+                size_t offset = sizeof(TraceFileHeader_t);
+                while (offset + sizeof(TraceChunkHeader_t) <= m_size)
+                {
+                    auto chunk = reinterpret_cast<const TraceChunkHeader_t *>(m_base + offset);
+                    offset += sizeof(TraceChunkHeader_t) + chunk->num_bytes;
+                    // A recording that was killed may end with a partial chunk
+                    if (offset > m_size)
+                    {
+                        break;
+                    }
+                    sparta_assert(chunk->hart_index < m_chunks.size(),
+                                  "Trace " << m_path << " has a chunk of unknown hart " << chunk->hart_index);
+                    m_chunks[chunk->hart_index].push_back(chunk);
+                }
+            };
+
+            inline auto advise(const TraceChunkHeader_t *chunk, const int &advice) const -> void
+            {
+                static const uintptr_t page_mask = ~uintptr_t(::sysconf(_SC_PAGESIZE) - 1);
+                const uintptr_t begin = reinterpret_cast<uintptr_t>(chunk) & page_mask;
+                const uintptr_t end = reinterpret_cast<uintptr_t>(payload(chunk) + chunk->num_bytes);
+                ::madvise(reinterpret_cast<void *>(begin), end - begin, advice);
+            };
+
+            inline auto unmap() -> void
+            {
+                if (m_base != nullptr)
+                {
+                    ::munmap(const_cast<uint8_t *>(m_base), m_size);
+                    m_base = nullptr;
+                }
+            };
+
+        private:
+            // Path of the trace file
+            const std::string m_path;
+            // Beginning of the mapping
+            const uint8_t *m_base = nullptr;
+            // Size of the mapping
+            size_t m_size = 0;
+            // Chunks of every hart in program order
+            std::vector<std::vector<const TraceChunkHeader_t *>> m_chunks;
+            // Instructions of every hart before each of its chunks, from the index
+            std::vector<std::vector<uint64_t>> m_inst_counts;
+            // The file has a chunk index
+            bool m_has_index = false;
+        };
+
+        /**
+         * @brief Event stream of one hart decoded from a mapped trace
+         */
+        class TraceStream
+        {
+        public:
+            TraceStream(const TraceStream &rhs) = delete;
+            TraceStream &operator=(const TraceStream &rhs) = delete;
+
+            /**
+             * @brief Constructor
+             * @param reader The mapped trace
+             * @param hart_index Hart index within the traced process
+             */
+            TraceStream(const TraceReader &reader, const HartID_t &hart_index)
+                : m_reader(reader), m_hart_index(hart_index), m_chunks(reader.getChunks(hart_index))
+            {
+                seekChunk(0);
+            };
+
+            /**
+             * @brief Check whether the stream is exhausted
+             * @return True if no event is left
+             */
+            inline auto empty() const -> bool
+            {
+                return m_decoder.empty();
+            };
+
+            /**
+             * @brief Get the current event
+             * @return The current event
+             */
+            inline auto front() const -> const cpu::ThreadEvent_t &
+            {
+                sparta_assert(!empty(), "Trace stream is exhausted");
+                return m_decoder.current();
+            };
+
+            /**
+             * @brief Move to the next event
+             *
+             * @return void
+             */
+            inline auto popFront() -> void
+            {
+                m_decoder.next();
+                if (SPARTA_EXPECT_FALSE(m_decoder.empty()))
+                {
+                    m_reader.dontNeed(m_chunks[m_chunk_index]);
+                    seekChunk(m_chunk_index + 1);
+                }
+            };
+
+            /**
+             * @brief Move to an instruction
+             * @param inst_count Instructions of the hart to skip from the beginning
+             *
+             * Decoding starts at the indexed chunk holding the instruction, so only
+             * the events in front of it within that chunk are decoded.
+             *
+             * @return void
+             */
+            auto seek(const uint64_t &inst_count) -> void
+            {
+                const size_t chunk_index = m_reader.findChunk(m_hart_index, inst_count);
+                uint64_t skipped = m_reader.getInstCount(m_hart_index, chunk_index);
+                seekChunk(chunk_index);
+                // Stop at an instruction, events in between belong to the skipped part
+                while (!empty() && (skipped < inst_count || front().tag != cpu::ThreadEvent_t::InsnTag))
+                {
+                    if (front().tag == cpu::ThreadEvent_t::InsnTag)
+                    {
+                        skipped++;
+                    }
+                    popFront();
+                }
+            };
+
+        private:
+            /**
+             * @brief Start decoding a chunk
+             * @param chunk_index Index of the chunk in the chunk list of the hart
+             *
+             * @return void
+             */
+            inline auto seekChunk(const size_t &chunk_index) -> void
+            {
+                m_chunk_index = chunk_index;
+                if (m_chunk_index >= m_chunks.size())
+                {
+                    return;
+                }
+                // Chunks of other harts sit in between, ask for the next one ahead of time
+                if (m_chunk_index + 1 < m_chunks.size())
+                {
+                    m_reader.willNeed(m_chunks[m_chunk_index + 1]);
+                }
+                auto chunk = m_chunks[m_chunk_index];
+                m_decoder.reset(TraceReader::payload(chunk), chunk->num_events);
+            };
+
+        private:
+            // The mapped trace
+            const TraceReader &m_reader;
+            // Hart index within the traced process
+            const HartID_t m_hart_index;
+            // Chunks of this hart
+            const std::vector<const TraceChunkHeader_t *> &m_chunks;
+            // Index of the chunk being decoded
+            size_t m_chunk_index = 0;
+            // Decoder of the current chunk
+            EventDecoder m_decoder;
+        };
+
+    } // namespace iss
+
+} // namespace archXplore
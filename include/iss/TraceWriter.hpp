@@ -0,0 +1,353 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "iss/EventCodec.hpp"
+#include "iss/TraceFormat.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+
+        /*
+         * @brief A filled or empty trace chunk
+         */
+        struct TraceBuffer_t
+        {
+            TraceChunkHeader_t header;
+            // Instructions of the hart before the chunk
+            uint64_t inst_count;
+            std::vector<uint8_t> bytes;
+        };
+
+        /**
+         * @brief Appends trace chunks to a file from a background thread
+         *
+         * Producers fill buffers taken from acquire() and hand them back with
+         * submit(). Neither call touches the file. Written buffers are recycled,
+         * and producers outrunning the disk wait in acquire() once every hart
+         * holds BUFFERS_PER_HART of them. A failed write stops the writer thread
+         * from writing, the error is thrown to the producers by their next call.
+         * Closing the writer appends the chunk index.
+         */
+        class TraceWriter
+        {
+        public:
+            // Buffers allocated for each hart before producers wait for the writer
+            static constexpr size_t BUFFERS_PER_HART = 4;
+
+            TraceWriter(const TraceWriter &rhs) = delete;
+            TraceWriter &operator=(const TraceWriter &rhs) = delete;
+
+            /**
+             * @brief Constructor
+             * @param path Path of the trace file
+             * @param num_harts Number of harts of the traced process
+             */
+            TraceWriter(const std::string &path, const HartID_t &num_harts)
+                : m_max_buffers(num_harts * BUFFERS_PER_HART)
+            {
+                m_file = std::fopen(path.c_str(), "wb");
+                if (m_file == nullptr)
+                {
+                    throw std::runtime_error("Unable to open trace file " + path);
+                }
+                TraceFileHeader_t header{};
+                std::memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+                header.version = TRACE_VERSION;
+                header.num_harts = num_harts;
+                header.encoding = EventEncoding_t::DELTA;
+                write(&header, sizeof(header));
+                m_thread = std::thread(&TraceWriter::run, this);
+            };
+
+            /**
+             * @brief Destructor
+             */
+            ~TraceWriter()
+            {
+                try
+                {
+                    close();
+                }
+                catch (const std::runtime_error &e)
+                {
+                    std::cerr << e.what() << std::endl;
+                }
+            };
+
+            /**
+             * @brief Get an empty buffer
+             * @return Buffer with TRACE_CHUNK_SIZE payload bytes
+             */
+            auto acquire() -> std::unique_ptr<TraceBuffer_t>
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_free_cond.wait(lock, [this]
+                                     { return !m_free_buffers.empty() || m_num_buffers < m_max_buffers || !m_error.empty(); });
+                    checkError();
+                    if (!m_free_buffers.empty())
+                    {
+                        auto buffer = std::move(m_free_buffers.back());
+                        m_free_buffers.pop_back();
+                        return buffer;
+                    }
+                    m_num_buffers++;
+                }
+                auto buffer = std::make_unique<TraceBuffer_t>();
+                buffer->bytes.resize(TRACE_CHUNK_SIZE);
+                return buffer;
+            };
+
+            /**
+             * @brief Queue a filled buffer for writing
+             * @param buffer The buffer, its header describes the payload
+             *
+             * @return void
+             */
+            auto submit(std::unique_ptr<TraceBuffer_t> buffer) -> void
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    checkError();
+                    m_pending_buffers.emplace_back(std::move(buffer));
+                }
+                m_cond.notify_one();
+            };
+
+            /**
+             * @brief Write all queued buffers and the index, then close the file
+             *
+             * @return void
+             */
+            auto close() -> void
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_stop)
+                    {
+                        return;
+                    }
+                    m_stop = true;
+                }
+                m_cond.notify_one();
+                m_thread.join();
+                if (!m_error.empty())
+                {
+                    std::fclose(m_file);
+                    m_file = nullptr;
+                    throw std::runtime_error(m_error);
+                }
+                TraceFooter_t footer{};
+                footer.index_offset = m_offset;
+                footer.num_entries = m_index.size();
+                std::memcpy(footer.magic, TRACE_INDEX_MAGIC, sizeof(footer.magic));
+                write(m_index.data(), m_index.size() * sizeof(TraceIndexEntry_t));
+                write(&footer, sizeof(footer));
+                std::fclose(m_file);
+                m_file = nullptr;
+            };
+
+        private:
+            /**
+             * @brief Writer thread
+             */
+            auto run() -> void
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (true)
+                {
+                    m_cond.wait(lock, [this]
+                                { return m_stop || !m_pending_buffers.empty(); });
+                    if (m_pending_buffers.empty())
+                    {
+                        break;
+                    }
+                    auto buffer = std::move(m_pending_buffers.front());
+                    m_pending_buffers.pop_front();
+                    // Buffers queued after a failure are dropped
+                    const bool failed = !m_error.empty();
+                    lock.unlock();
+                    try
+                    {
+                        if (!failed)
+                        {
+                            writeChunk(*buffer);
+                        }
+                    }
+                    catch (const std::runtime_error &e)
+                    {
+                        lock.lock();
+                        m_error = e.what();
+                        lock.unlock();
+                    }
+                    lock.lock();
+                    m_free_buffers.emplace_back(std::move(buffer));
+                    m_free_cond.notify_all();
+                }
+                std::fflush(m_file);
+            };
+
+            /**
+             * @brief Append a chunk and its index entry, on the writer thread
+             * @param buffer The filled buffer
+             *
+             * @return void
+             */
+            auto writeChunk(const TraceBuffer_t &buffer) -> void
+            {
+                TraceIndexEntry_t entry{};
+                entry.offset = m_offset;
+                entry.inst_count = buffer.inst_count;
+                entry.first_event_id = buffer.header.first_event_id;
+                entry.hart_index = buffer.header.hart_index;
+                m_index.push_back(entry);
+                write(&buffer.header, sizeof(buffer.header));
+                write(buffer.bytes.data(), buffer.header.num_bytes);
+                m_offset += sizeof(buffer.header) + buffer.header.num_bytes;
+            };
+
+            /**
+             * @brief Throw the error of the writer thread, the queue lock is held
+             *
+             * @return void
+             */
+            auto checkError() const -> void
+            {
+                if (__glibc_unlikely(!m_error.empty()))
+                {
+                    throw std::runtime_error(m_error);
+                }
+            };
+
+            auto write(const void *data, const size_t &size) -> void
+            {
+                if (std::fwrite(data, 1, size, m_file) != size)
+                {
+                    throw std::runtime_error("Unable to write trace file");
+                }
+            };
+
+        private:
+            // Trace file
+            std::FILE *m_file = nullptr;
+            // Writer thread
+            std::thread m_thread;
+            // Queue lock
+            std::mutex m_mutex;
+            // Signals pending buffers or stop
+            std::condition_variable m_cond;
+            // Signals recycled buffers or an error
+            std::condition_variable m_free_cond;
+            // Buffers allocated so far and the limit
+            size_t m_num_buffers = 0;
+            const size_t m_max_buffers;
+            // Error of the writer thread, empty while writes succeed
+            std::string m_error;
+            // Buffers waiting to be written
+            std::deque<std::unique_ptr<TraceBuffer_t>> m_pending_buffers;
+            // Written buffers ready for reuse
+            std::vector<std::unique_ptr<TraceBuffer_t>> m_free_buffers;
+            // No more buffers will be submitted
+            bool m_stop = false;
+            // File offset of the next chunk, only used by the writer thread
+            uint64_t m_offset = sizeof(TraceFileHeader_t);
+            // Index entries of written chunks, only used by the writer thread
+            std::vector<TraceIndexEntry_t> m_index;
+        };
+
+        /**
+         * @brief Encodes the event stream of one hart into trace chunks
+         */
+        class TraceRecorder
+        {
+        public:
+            TraceRecorder(const TraceRecorder &rhs) = delete;
+            TraceRecorder &operator=(const TraceRecorder &rhs) = delete;
+
+            /**
+             * @brief Constructor
+             * @param writer Writer of the trace file
+             * @param hart_index Hart index within the traced process
+             */
+            TraceRecorder(TraceWriter &writer, const HartID_t &hart_index)
+                : m_writer(writer), m_hart_index(hart_index)
+            {
+                acquire();
+            };
+
+            /**
+             * @brief Record an event
+             * @param ev The event
+             *
+             * @return void
+             */
+            inline auto record(const cpu::ThreadEvent_t &ev) -> void
+            {
+                if (m_buffer->header.num_events == 0)
+                {
+                    m_buffer->header.first_event_id = ev.event_id;
+                    m_buffer->inst_count = m_inst_count;
+                }
+                if (ev.tag == cpu::ThreadEvent_t::InsnTag)
+                {
+                    m_inst_count++;
+                }
+                m_encoder.encode(ev);
+                m_buffer->header.num_events++;
+                if (__glibc_unlikely(m_encoder.full()))
+                {
+                    flush();
+                }
+            };
+
+            /**
+             * @brief Hand the current chunk to the writer
+             *
+             * @return void
+             */
+            inline auto flush() -> void
+            {
+                if (m_buffer->header.num_events == 0)
+                {
+                    return;
+                }
+                m_buffer->header.num_bytes = m_encoder.size();
+                m_writer.submit(std::move(m_buffer));
+                acquire();
+            };
+
+        private:
+            inline auto acquire() -> void
+            {
+                m_buffer = m_writer.acquire();
+                m_buffer->header = TraceChunkHeader_t{};
+                m_buffer->header.hart_index = m_hart_index;
+                m_encoder.reset(m_buffer->bytes.data(), m_buffer->bytes.size());
+            };
+
+        private:
+            // Writer of the trace file
+            TraceWriter &m_writer;
+            // Hart index within the traced process
+            const HartID_t m_hart_index;
+            // Chunk being filled
+            std::unique_ptr<TraceBuffer_t> m_buffer;
+            // Encoder of the current chunk
+            EventEncoder m_encoder;
+            // Instructions recorded so far
+            uint64_t m_inst_count = 0;
+        };
+
+    } // namespace iss
+
+} // namespace archXplore
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <sched.h>
+
+#include <chrono>
+#include <cstdint>
+
+namespace archXplore
+{
+    namespace iss
+    {
+
+        /*
+         * @brief How a side of an event channel waits for the other side
+         *
+         * A waiter polls the channel, then yields the core between polls, then
+         * blocks until the channel signals progress or the block times out.
+         */
+        struct WaitPolicy_t
+        {
+            // Polls before the waiter starts yielding
+            uint32_t spin_count = 4096;
+            // Yields before the waiter blocks
+            uint32_t yield_count = 64;
+            // Block after yielding, otherwise keep yielding
+            bool block = true;
+            // Longest single block in microseconds, the channel is polled again after it
+            uint32_t block_timeout_us = 100;
+        };
+
+        /*
+         * @brief Time a waiter spent in each stage
+         */
+        struct WaitStats_t
+        {
+            // Waits that did not succeed at the first poll
+            uint64_t waits = 0;
+            // Host time in nanoseconds
+            uint64_t spin_time = 0;
+            uint64_t yield_time = 0;
+            uint64_t block_time = 0;
+        };
+
+        /**
+         * @brief Spin, then yield, then block until a poll succeeds
+         */
+        class AdaptiveWaiter
+        {
+        public:
+            AdaptiveWaiter(const WaitPolicy_t &policy = WaitPolicy_t{}) : m_policy(policy){};
+
+            /**
+             * @brief Set the policy of later waits
+             * @param policy The policy
+             *
+             * @return void
+             */
+            inline auto setPolicy(const WaitPolicy_t &policy) -> void
+            {
+                m_policy = policy;
+            };
+
+            /**
+             * @brief Get the policy
+             * @return The policy
+             */
+            inline auto getPolicy() const -> const WaitPolicy_t &
+            {
+                return m_policy;
+            };
+
+            /**
+             * @brief Wait until the poll succeeds
+             * @param poll Returns true once the awaited condition holds
+             * @param block Blocks for at most the given timeout or until the channel signals progress
+             *
+             * @return void
+             */
+            template <typename Poll, typename Block>
+            inline auto wait(Poll &&poll, Block &&block) -> void
+            {
+                if (__glibc_likely(poll()))
+                {
+                    return;
+                }
+                m_stats.waits++;
+                auto stage_start = std::chrono::steady_clock::now();
+                bool done = false;
+                for (uint32_t i = 0; i < m_policy.spin_count && !done; ++i)
+                {
+                    done = poll();
+                }
+                stage_start = account(m_stats.spin_time, stage_start);
+                for (uint32_t i = 0; i < m_policy.yield_count && !done; ++i)
+                {
+                    sched_yield();
+                    done = poll();
+                }
+                stage_start = account(m_stats.yield_time, stage_start);
+                if (done)
+                {
+                    return;
+                }
+                const std::chrono::microseconds timeout(m_policy.block_timeout_us);
+                while (!poll())
+                {
+                    if (m_policy.block)
+                    {
+                        block(timeout);
+                    }
+                    else
+                    {
+                        sched_yield();
+                    }
+                }
+                account(m_policy.block ? m_stats.block_time : m_stats.yield_time, stage_start);
+            };
+
+            /**
+             * @brief Get the time spent waiting
+             * @return Wait statistics
+             */
+            inline auto getStats() const -> const WaitStats_t &
+            {
+                return m_stats;
+            };
+
+        private:
+            static inline auto account(uint64_t &total, const std::chrono::steady_clock::time_point &start)
+                -> std::chrono::steady_clock::time_point
+            {
+                const auto now = std::chrono::steady_clock::now();
+                total += std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count();
+                return now;
+            };
+
+        private:
+            // Wait policy
+            WaitPolicy_t m_policy;
+            // Time spent in each stage
+            WaitStats_t m_stats;
+        };
+
+    } // namespace iss
+} // namespace archXplore
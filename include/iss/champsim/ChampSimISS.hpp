@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+
+#include "iss/AbstractISS.hpp"
+#include "iss/champsim/ChampSimReader.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+        namespace champsim
+        {
+
+            class ChampSimISS : public AbstractISS
+            {
+            public:
+                // Instructions decoded per batch
+                static constexpr size_t DECODE_BATCH = 1024;
+
+                inline auto initCPUState() -> void override;
+
+                inline auto generateFetchRequest(const Addr_t& addr, const size_t& fetch_size) -> void override;
+
+                inline auto processFetchResponse(const uint8_t* data) -> FetchGroup_t override;
+
+                ChampSimISS();
+
+                ~ChampSimISS();
+
+            protected:
+
+                inline auto openTrace() -> void;
+
+                inline auto exhausted() -> bool;
+
+                inline auto wakeUpMonitor() -> void override;
+
+                inline auto initialize() -> void override;
+
+            private:
+
+                // Instructions of the pending fetch
+                FetchPackage m_fetch_package;
+
+                // A fetch request waits for its response
+                bool m_fetch_pending = false;
+
+                // Decoder of the trace of this hart
+                std::unique_ptr<ChampSimReader> m_reader;
+
+                // Decoded instructions
+                std::vector<cpu::StaticInst_t> m_batch;
+
+                // Next instruction in the batch
+                size_t m_batch_pos = 0;
+
+            };
+        }
+    } // namespace iss
+} // namespace archXplore
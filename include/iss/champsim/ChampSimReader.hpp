@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "cpu/StaticInst.hpp"
+#include "utils/PrefetchReader.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+        namespace champsim
+        {
+
+            /*
+             * @brief Instruction record of a ChampSim trace
+             */
+            struct ChampSimRecord_t
+            {
+                // Instruction pointer
+                uint64_t ip;
+                // The instruction is a branch
+                uint8_t is_branch;
+                // The branch was taken
+                uint8_t branch_taken;
+                // Register numbers, zero for unused slots
+                uint8_t destination_registers[2];
+                uint8_t source_registers[4];
+                // Memory addresses, zero for unused slots
+                uint64_t destination_memory[2];
+                uint64_t source_memory[4];
+            };
+
+            static_assert(sizeof(ChampSimRecord_t) == 64, "ChampSim records are 64 bytes");
+
+            /**
+             * @brief Decodes a ChampSim trace into instructions
+             *
+             * ChampSim records carry neither instruction lengths nor access sizes.
+             * The length is taken from the distance to the next record when that
+             * is a plausible fall-through, anything else is a redirect. Only the
+             * first memory operand of a record is kept.
+             */
+            class ChampSimReader
+            {
+            public:
+                // Register numbers ChampSim uses to mark branch behaviour
+                static constexpr uint8_t REG_STACK_POINTER = 6;
+                static constexpr uint8_t REG_FLAGS = 25;
+                static constexpr uint8_t REG_INSTRUCTION_POINTER = 26;
+
+                // Length of an instruction followed by a redirect
+                static constexpr uint8_t DEFAULT_INST_LEN = 4;
+
+                // Longest fall-through distance taken as an instruction length
+                static constexpr uint8_t MAX_INST_LEN = 15;
+
+                // Access size of a memory operand, as a power of two
+                static constexpr uint8_t MEM_SIZE_SHIFT = 3;
+
+                // Records read at once
+                static constexpr size_t RECORD_BATCH = 4096;
+
+                ChampSimReader(const ChampSimReader &rhs) = delete;
+                ChampSimReader &operator=(const ChampSimReader &rhs) = delete;
+
+                /**
+                 * @brief Constructor
+                 * @param path Path of the trace, .xz and .gz traces are decompressed
+                 */
+                ChampSimReader(const std::string &path) : m_file(path)
+                {
+                    m_records.resize(RECORD_BATCH + 1);
+                };
+
+                /**
+                 * @brief Decode the next instructions
+                 * @param insts Decoded instructions are appended here
+                 * @param max_insts Maximum number of instructions
+                 * @return Number of decoded instructions, zero once the trace is exhausted
+                 */
+                auto read(std::vector<cpu::StaticInst_t> &insts, const size_t &max_insts) -> size_t
+                {
+                    size_t num_insts = 0;
+                    for (; num_insts < max_insts; ++num_insts)
+                    {
+                        // The successor of a record decides its length and redirect
+                        if (m_pos + 1 >= m_num_records)
+                        {
+                            fill();
+                        }
+                        if (m_pos >= m_num_records)
+                        {
+                            break;
+                        }
+                        const bool has_next = m_pos + 1 < m_num_records;
+                        insts.emplace_back(decode(m_records[m_pos], has_next ? &m_records[m_pos + 1] : nullptr));
+                        m_pos++;
+                    }
+                    return num_insts;
+                };
+
+            private:
+                /**
+                 * @brief Read the next records, keeping the unconsumed ones
+                 *
+                 * The file only delivers fewer records than requested at its end.
+                 *
+                 * @return void
+                 */
+                auto fill() -> void
+                {
+                    const size_t kept = m_num_records - m_pos;
+                    std::copy(m_records.begin() + m_pos, m_records.begin() + m_num_records, m_records.begin());
+                    const size_t bytes = m_file.read(m_records.data() + kept, (m_records.size() - kept) * sizeof(ChampSimRecord_t));
+                    m_pos = 0;
+                    m_num_records = kept + bytes / sizeof(ChampSimRecord_t);
+                };
+
+                /**
+                 * @brief Convert a record
+                 * @param record The record
+                 * @param next The next record, nullptr at the end of the trace
+                 * @return The instruction
+                 */
+                auto decode(const ChampSimRecord_t &record, const ChampSimRecord_t *next) -> cpu::StaticInst_t
+                {
+                    cpu::StaticInst_t inst{};
+                    inst.uid = m_inst_counter++;
+                    inst.pc = record.ip;
+                    inst.len = DEFAULT_INST_LEN;
+                    if (next != nullptr && next->ip > record.ip && next->ip - record.ip <= MAX_INST_LEN)
+                    {
+                        inst.len = next->ip - record.ip;
+                    }
+                    inst.br_info.target_pc = next != nullptr ? next->ip : record.ip + inst.len;
+                    inst.br_info.redirect = (inst.br_info.target_pc != record.ip + inst.len);
+                    // Registers
+                    auto reg = [](const uint8_t &id)
+                    {
+                        return cpu::RegisterInfo_t{id == 0 ? cpu::REG_TYPE_NONE : cpu::REG_TYPE_GPR, id};
+                    };
+                    inst.src_reg1 = reg(record.source_registers[0]);
+                    inst.src_reg2 = reg(record.source_registers[1]);
+                    inst.src_reg3 = reg(record.source_registers[2]);
+                    inst.dst_reg = reg(record.destination_registers[0]);
+                    // Memory, loads first
+                    inst.func_info = cpu::TYPE_ALU;
+                    for (auto &addr : record.source_memory)
+                    {
+                        if (addr != 0)
+                        {
+                            inst.mem_info = cpu::MemoryInfo_t{addr, MEM_SIZE_SHIFT, false};
+                            inst.func_info = cpu::TYPE_LOAD;
+                            break;
+                        }
+                    }
+                    if (inst.func_info == cpu::TYPE_ALU)
+                    {
+                        for (auto &addr : record.destination_memory)
+                        {
+                            if (addr != 0)
+                            {
+                                inst.mem_info = cpu::MemoryInfo_t{addr, MEM_SIZE_SHIFT, true};
+                                inst.func_info = cpu::TYPE_STORE;
+                                break;
+                            }
+                        }
+                    }
+                    if (record.is_branch)
+                    {
+                        inst.func_info = classifyBranch(record);
+                    }
+                    return inst;
+                };
+
+                /**
+                 * @brief Classify a branch by the registers it touches, as ChampSim does
+                 * @param record The record
+                 * @return The branch type
+                 */
+                static auto classifyBranch(const ChampSimRecord_t &record) -> cpu::FunctionInfo_t
+                {
+                    bool reads_sp = false, reads_flags = false, reads_ip = false, reads_other = false;
+                    bool writes_sp = false, writes_ip = false;
+                    for (auto &reg : record.source_registers)
+                    {
+                        reads_sp |= (reg == REG_STACK_POINTER);
+                        reads_flags |= (reg == REG_FLAGS);
+                        reads_ip |= (reg == REG_INSTRUCTION_POINTER);
+                        reads_other |= (reg != 0 && reg != REG_STACK_POINTER && reg != REG_FLAGS && reg != REG_INSTRUCTION_POINTER);
+                    }
+                    for (auto &reg : record.destination_registers)
+                    {
+                        writes_sp |= (reg == REG_STACK_POINTER);
+                        writes_ip |= (reg == REG_INSTRUCTION_POINTER);
+                    }
+                    if (!reads_sp && !reads_flags && writes_ip && !reads_other)
+                    {
+                        return cpu::TYPE_JUMP;
+                    }
+                    if (!reads_sp && !reads_flags && writes_ip && reads_other)
+                    {
+                        return cpu::TYPE_JUMP_REG;
+                    }
+                    if (!reads_sp && reads_ip && !writes_sp && writes_ip && reads_flags && !reads_other)
+                    {
+                        return cpu::TYPE_BRANCH;
+                    }
+                    if (reads_sp && reads_ip && writes_sp && writes_ip && !reads_flags)
+                    {
+                        return cpu::TYPE_CALL;
+                    }
+                    if (reads_sp && !reads_ip && writes_sp && writes_ip)
+                    {
+                        return cpu::TYPE_RETURN;
+                    }
+                    return cpu::TYPE_OTHER;
+                };
+
+            private:
+                // Trace file, decompressed ahead of the decoder
+                utils::PrefetchReader m_file;
+                // Records read from the file
+                std::vector<ChampSimRecord_t> m_records;
+                // Valid records
+                size_t m_num_records = 0;
+                // Next record to decode
+                size_t m_pos = 0;
+                // Instructions decoded so far
+                EventID_t m_inst_counter = 0;
+            };
+
+        } // namespace champsim
+    } // namespace iss
+} // namespace archXplore
@@ -1,10 +1,11 @@
 #pragma once
 
 #include <vector>
-#include <deque>
+#include <optional>
 
 #include "iss/AbstractISS.hpp"
 #include "iss/EventSubscriber.hpp"
+#include "iss/StaticCodeTable.hpp"
 
 namespace archXplore
 {
@@ -16,12 +17,14 @@ namespace archXplore
             class QemuISS : public AbstractISS
             {
             public:
+                // Events requested from the subscriber at once
+                static constexpr size_t FETCH_BATCH = 64;
 
                 inline auto initCPUState() -> void override;
 
                 inline auto generateFetchRequest(const Addr_t& addr, const size_t& fetch_size) -> void override;
 
-                inline auto processFetchResponse(const uint8_t* data) -> std::vector<cpu::StaticInst_t> override;
+                inline auto processFetchResponse(const uint8_t* data) -> FetchGroup_t override;
 
                 QemuISS();
             
@@ -33,16 +36,87 @@ namespace archXplore
 
                 inline auto handleSyscallApi(const cpu::ThreadEvent_t& ev) -> void;
 
+                /**
+                 * @brief Add an event to the pending fetch package
+                 * @param ev The event
+                 * @param in_place The event stays in the received chunk until the package is consumed
+                 * @param cur_fetch_pc Pc of the next instruction of the package, advanced past the event
+                 * @param fetch_end End of the fetch range
+                 * @param exit_loop Set when the package ends
+                 * @return True if the event was consumed
+                 */
+                inline auto fetchEvent(const cpu::ThreadEvent_t& ev, const bool& in_place, Addr_t& cur_fetch_pc,
+                                       const Addr_t& fetch_end, bool& exit_loop) -> bool;
+
+                inline auto frontEvent() -> const cpu::ThreadEvent_t&;
+
+                /**
+                 * @brief Get the waits of the subscriber and of the static code table
+                 * @return Wait statistics of the hart
+                 */
+                inline auto getWaitStats() const -> WaitStats_t;
+
+                inline auto reportWaits() -> void;
+
+                inline auto applyWaitPolicy() -> void;
+
+                inline auto expandBlock() -> void;
+
+                /**
+                 * @brief Check whether expanded instructions are left
+                 * @return True if an expanded event waits to be fetched
+                 */
+                inline auto hasExpandedEvents() const -> bool
+                {
+                    return m_expanded_index < m_expanded_events.size();
+                };
+
                 inline auto wakeUpMonitor() -> void override;
 
+                inline auto notifiesWakeUp() const -> bool override;
+
                 inline auto initialize() -> void override;
 
             private:
 
-                std::deque<std::vector<cpu::StaticInst_t>> m_fetch_buffer;
+                // Instructions of the pending fetch
+                FetchPackage m_fetch_package;
+
+                // A fetch request waits for its response
+                bool m_fetch_pending = false;
 
                 std::unique_ptr<EventSubscriber> m_event_queue;
 
+                // Static code table shared by all harts of the process
+                const StaticCodeTable *m_static_code = nullptr;
+
+                // Instruction events expanded from the last block record, reused for every block
+                std::vector<cpu::ThreadEvent_t> m_expanded_events;
+
+                // Next expanded event to fetch
+                size_t m_expanded_index = 0;
+
+                // Memory accesses of the block record chain being expanded, reused for every block
+                std::vector<cpu::BlockMemAccess_t> m_block_accesses;
+
+                // Last instruction of the last block, waiting for its successor
+                std::optional<cpu::StaticInst_t> m_held_inst;
+
+                // Instruction counter of expanded blocks
+                EventID_t m_expanded_inst_counter = 0;
+
+                // Waits for block definitions of the static code table
+                AdaptiveWaiter m_static_code_waiter;
+
+                // Subscriber and definition waits already added to the hart statistics
+                WaitStats_t m_reported_waits;
+
+                // The wait policy of the process was given to the subscriber
+                bool m_wait_policy_applied = false;
+
+                // Arriving events wake up the hart through the listener of the system
+                bool m_notifies_wakeup = false;
+
             };
         }
     } // namespace iss
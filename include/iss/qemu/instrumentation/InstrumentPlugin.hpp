@@ -6,13 +6,19 @@ extern "C"
 }
 
 #include <unordered_map>
-#include <shared_mutex>
+#include <atomic>
 #include <mutex>
 #include <vector>
 #include <iostream>
+#include <fstream>
 
 #include "cpu/StaticInst.hpp"
+#include "iceoryx_posh/popo/subscriber.hpp"
+#include "iceoryx_posh/popo/listener.hpp"
+
 #include "iss/EventPublisher.hpp"
+#include "iss/TraceWriter.hpp"
+#include "utils/Arena.hpp"
 
 namespace archXplore
 {
@@ -26,17 +32,73 @@ namespace archXplore
             class InstrumentPlugin
             {
             public:
+                // Blocks a VCPU executes between two polls of the simulator requests
+                static constexpr uint64_t REQUEST_POLL_BLOCKS = 1024;
+
                 /*
-                 * @brief Instruction cache entry
+                 * @brief Immutable instruction descriptor, created once per translated instruction
                  */
-                struct InstCacheEntry_t
+                struct InstDescriptor_t
                 {
                     Addr_t pc;
                     uint32_t opcode;
                     uint8_t len;
                 };
 
-                typedef std::unordered_map<Addr_t, InstCacheEntry_t> InstCache_t;
+                /*
+                 * @brief Immutable basic block descriptor, created once per translated block
+                 */
+                struct BlockDescriptor_t
+                {
+                    BlockDescriptor_t(const BlockID_t &id, const Addr_t &pc, const uint16_t &num_insts,
+                                      const InstDescriptor_t *insts)
+                        : id(id), pc(pc), num_insts(num_insts), insts(insts){};
+
+                    const BlockID_t id;
+                    const Addr_t pc;
+                    const uint16_t num_insts;
+                    const InstDescriptor_t *insts;
+                    // The definition reached the simulator
+                    mutable std::atomic<bool> flushed{false};
+                };
+
+                /*
+                 * @brief Basic block vector entry, one per distinct block start address
+                 */
+                struct BBVEntry_t
+                {
+                    uint64_t id;
+                    qemu_plugin_u64 count;
+                };
+
+                /*
+                 * @brief Per-VCPU state, one cache line aligned slot for each VCPU
+                 */
+                struct alignas(64) VCPUState_t
+                {
+                    // Instruction counter
+                    EventID_t inst_counter = 0;
+                    // The last executed instruction waits for its successor, across windows without events too
+                    bool inst_pending = false;
+                    // Event counter
+                    EventID_t event_counter = 0;
+                    // Pending block
+                    const BlockDescriptor_t *pending_block = nullptr;
+                    // Event publisher
+                    std::unique_ptr<EventPublisher> publisher;
+                    // Last executed instruction
+                    cpu::StaticInst_t last_inst;
+                    // Block record under construction
+                    cpu::BlockEvent_t block_record;
+                    // Basic block vector file
+                    std::unique_ptr<std::ofstream> bbv_file;
+                    // Trace recorder
+                    std::unique_ptr<TraceRecorder> trace;
+                };
+
+                typedef utils::Arena<InstDescriptor_t> InstArena_t;
+
+                typedef utils::Arena<BlockDescriptor_t> BlockArena_t;
 
                 /**
                  * @brief Start publish service
@@ -45,17 +107,189 @@ namespace archXplore
                  */
                 static auto startPublishService() -> void
                 {
+                    // Profiling and trace-only runs go without the simulator
+                    if (m_bbv_interval > 0 || m_trace_only)
+                    {
+                        return;
+                    }
                     // Initialize RouDi App
                     auto runtime_name = iox::RuntimeName_t(iox::TruncateToCapacity, m_runtime.c_str());
                     iox::runtime::PoshRuntime::initRuntime(runtime_name);
-                    // Preallocate memory for possible harts
-                    for (HartID_t i = 0; i < m_max_harts; ++i)
+                    // Block definitions are shared by all harts of this process
+                    if (m_block_stream)
                     {
-                        m_event_publishers[i] = nullptr;
-                        m_last_insts[i] = cpu::StaticInst_t();
-                        m_inst_counters[i] = 0;
-                        m_event_counters[i] = 0;
+                        m_static_publisher = std::make_unique<EventPublisher>(m_app_name, std::to_string(m_pid),
+                                                                              STATIC_CODE_SERVICE);
                     }
+                    // Listen to instrumentation requests of the simulator
+                    iox::popo::SubscriberOptions subscriberOptions;
+                    subscriberOptions.historyRequest = 1;
+                    auto app_name_str = iox::into<iox::lossy<iox::capro::IdString_t>>(m_app_name);
+                    auto instance_str = iox::into<iox::lossy<iox::capro::IdString_t>>(std::to_string(m_pid));
+                    auto event_name_str = iox::into<iox::lossy<iox::capro::IdString_t>>(std::string(CONTROL_SERVICE));
+                    m_control_subscriber = std::make_unique<iox::popo::Subscriber<ControlMessage_t>>(
+                        iox::capro::ServiceDescription{app_name_str, instance_str, event_name_str}, subscriberOptions);
+                    m_control_listener = std::make_unique<iox::popo::Listener>();
+                    m_control_listener->attachEvent(*m_control_subscriber, iox::popo::SubscriberEvent::DATA_RECEIVED,
+                                                    iox::popo::createNotificationCallback(controlReceived))
+                        .or_else([](auto)
+                                 { throw std::runtime_error("Unable to attach control subscriber"); });
+                };
+
+                /**
+                 * @brief Register the callbacks of the current instrumentation mode
+                 * @param id The QEMU plugin ID
+                 *
+                 * @return void
+                 */
+                static auto registerCallbacks(qemu_plugin_id_t id) -> void
+                {
+                    qemu_plugin_register_vcpu_tb_trans_cb(id, translateBasicBlock);
+
+                    qemu_plugin_register_vcpu_syscall_cb(id, syscall);
+
+                    qemu_plugin_register_vcpu_init_cb(id, threadInitialize);
+
+                    qemu_plugin_register_vcpu_exit_cb(id, threadExit);
+
+                    qemu_plugin_register_atexit_cb(id, qemuAtExit, NULL);
+                };
+
+                /**
+                 * @brief Control request received, called by the listener thread
+                 * @param subscriber The control subscriber
+                 *
+                 * @return void
+                 */
+                static auto controlReceived(iox::popo::Subscriber<ControlMessage_t> *subscriber) -> void
+                {
+                    bool take_successful = true;
+                    while (take_successful)
+                    {
+                        auto maybeMessage = subscriber->take();
+                        take_successful = maybeMessage.has_value();
+                        if (take_successful)
+                        {
+                            requestMode(maybeMessage.value()->mode, maybeMessage.value()->budget);
+                        }
+                    }
+                };
+
+                /**
+                 * @brief Request a new instrumentation mode from any thread
+                 *
+                 * QEMU reallocates the scoreboards when it creates a VCPU, so only VCPUs
+                 * touch them. The request is only published here, every VCPU polls its
+                 * generation every REQUEST_POLL_BLOCKS blocks and applies it.
+                 * @param mode The requested mode
+                 * @param budget Instructions to run in the requested mode, zero keeps it until the next request
+                 *
+                 * @return void
+                 */
+                static auto requestMode(const InstrumentMode_t &mode, const uint64_t &budget) -> void
+                {
+                    std::lock_guard<std::mutex> lock(m_request_mutex);
+                    m_requested_mode.store(mode);
+                    m_requested_budget = budget;
+                    m_request_generation.fetch_add(1, std::memory_order_release);
+                };
+
+                /**
+                 * @brief Apply a request of the simulator that no switch applied yet
+                 * @param vcpu_index The index of the VCPU
+                 * @param userdata The userdata pointer
+                 *
+                 * @return void
+                 */
+                static auto pollRequests(unsigned int vcpu_index, void *userdata) -> void
+                {
+                    qemu_plugin_u64_set(m_poll_count, vcpu_index, 0);
+                    if (m_request_generation.load(std::memory_order_acquire) !=
+                        m_applied_generation.load(std::memory_order_relaxed))
+                    {
+                        applyRequestedMode(vcpu_index, userdata);
+                    }
+                };
+
+                /**
+                 * @brief Switch to the requested instrumentation mode
+                 *
+                 * All translated blocks are flushed, the callbacks are registered again
+                 * once every VCPU left the translated code.
+                 * @param vcpu_index The index of the VCPU
+                 * @param userdata The userdata pointer
+                 *
+                 * @return void
+                 */
+                static auto applyRequestedMode(unsigned int vcpu_index, void *userdata) -> void
+                {
+                    if (m_switch_in_progress.exchange(true))
+                    {
+                        return;
+                    }
+                    InstrumentMode_t mode;
+                    uint64_t budget;
+                    {
+                        std::lock_guard<std::mutex> lock(m_request_mutex);
+                        m_applied_generation.store(m_request_generation.load(std::memory_order_relaxed),
+                                                   std::memory_order_relaxed);
+                        mode = m_requested_mode.load();
+                        budget = m_requested_budget;
+                    }
+                    if (mode == m_mode.load())
+                    {
+                        m_switch_in_progress = false;
+                        return;
+                    }
+                    // The simulator took over from the fast-forward threshold
+                    m_fast_forward_done.store(true);
+                    // Stale budget callbacks fire until the translations are flushed
+                    m_budget_done.store(true);
+                    m_previous_mode.store(m_mode.load());
+                    m_budget.store(budget);
+                    m_mode.store(mode);
+                    qemu_plugin_reset(m_plugin_id, modeSwitched);
+                };
+
+                /**
+                 * @brief Translations are flushed and no VCPU is running
+                 * @param id The QEMU plugin ID
+                 *
+                 * @return void
+                 */
+                static auto modeSwitched(qemu_plugin_id_t id) -> void
+                {
+                    // Hand everything recorded so far to the simulator
+                    if (m_mode.load() != InstrumentMode_t::FULL)
+                    {
+                        for (HartID_t i = 0; i < m_max_harts; ++i)
+                        {
+                            VCPUState_t &state = m_vcpu_states[i];
+                            if (state.publisher == nullptr)
+                            {
+                                continue;
+                            }
+                            if (m_block_stream && state.pending_block != nullptr)
+                            {
+                                flushBlock(i, false);
+                            }
+                            state.publisher->flush();
+                        }
+                    }
+                    // Instructions counted without events keep the instruction IDs of the harts in step
+                    const bool counted = m_previous_mode.load() != InstrumentMode_t::FULL;
+                    for (int i = 0; i < qemu_plugin_num_vcpus(); ++i)
+                    {
+                        if (counted)
+                        {
+                            m_vcpu_states[i].inst_counter += qemu_plugin_u64_get(m_inst_count, i);
+                        }
+                        qemu_plugin_u64_set(m_inst_count, i, 0);
+                    }
+                    m_budget_done.store(false);
+                    registerCallbacks(id);
+                    // A request that arrived during the switch is applied by the next poll
+                    m_switch_in_progress = false;
                 };
 
                 /**
@@ -78,13 +312,28 @@ namespace archXplore
                  */
                 static auto threadInitialize(qemu_plugin_id_t id, unsigned int vcpu_index) -> void
                 {
-                    assert(vcpu_index < m_max_harts);
+                    assert(vcpu_index < m_max_harts && m_max_harts <= MAX_HARTS);
                     // Calculate hart ID
                     const HartID_t hart_id = calculateHartID(vcpu_index);
+                    VCPUState_t &state = m_vcpu_states[vcpu_index];
+                    // Open the basic block vector file of this VCPU
+                    if (m_bbv_interval > 0)
+                    {
+                        state.bbv_file = std::make_unique<std::ofstream>(
+                            m_bbv_file + "." + std::to_string(vcpu_index) + ".bb");
+                        return;
+                    }
+                    // Create trace recorder
+                    if (m_trace_writer != nullptr && state.trace == nullptr)
+                    {
+                        state.trace = std::make_unique<TraceRecorder>(*m_trace_writer, vcpu_index);
+                    }
                     // Create event publisher
-                    if (m_event_publishers.at(vcpu_index) == nullptr)
+                    if (!m_trace_only && state.publisher == nullptr)
                     {
-                        m_event_publishers.at(vcpu_index) = std::make_unique<EventPublisher>(m_app_name, hart_id);
+                        state.publisher = std::make_unique<EventPublisher>(
+                            m_app_name, hart_id, std::chrono::microseconds(m_flush_latency),
+                            m_compress_events ? EventEncoding_t::DELTA : EventEncoding_t::RAW, m_wait_policy);
                     }
                 };
 
@@ -97,11 +346,59 @@ namespace archXplore
                  */
                 static auto threadExit(qemu_plugin_id_t id, unsigned int vcpu_index) -> void
                 {
-                    auto last_event = cpu::ThreadEvent_t(cpu::ThreadEvent_t::InsnTag, m_event_counters.at(vcpu_index)++,
-                                                         m_last_insts.at(vcpu_index));
-                    last_event.is_last = true;
-                    // Send instruction
-                    m_event_publishers.at(vcpu_index)->publish(true, last_event);
+                    if (m_bbv_interval > 0)
+                    {
+                        // Dump the last partial interval
+                        if (qemu_plugin_u64_get(m_inst_count, vcpu_index) > 0)
+                        {
+                            dumpBBV(vcpu_index, nullptr);
+                        }
+                        return;
+                    }
+                    VCPUState_t &state = m_vcpu_states[vcpu_index];
+                    if (m_block_stream && state.pending_block != nullptr)
+                    {
+                        // The last executed block closes the stream
+                        flushBlock(vcpu_index, true);
+                    }
+                    else
+                    {
+                        auto last_event = cpu::ThreadEvent_t(cpu::ThreadEvent_t::InsnTag, state.event_counter++, state.last_inst);
+                        last_event.is_last = true;
+                        // Send instruction
+                        emit(state, true, last_event);
+                    }
+                    if (state.trace != nullptr)
+                    {
+                        try
+                        {
+                            state.trace->flush();
+                        }
+                        catch (const std::runtime_error &e)
+                        {
+                            stopTrace(state, e);
+                        }
+                    }
+                    if (m_flush_stats && state.publisher != nullptr)
+                    {
+                        const FlushStats_t &stats = state.publisher->getFlushStats();
+                        std::lock_guard<std::mutex> lock(m_shared_resource_mutex);
+                        std::cerr << "Hart " << calculateHartID(vcpu_index) << " flush policy:"
+                                  << " events=" << stats.events
+                                  << " batch=" << stats.batch_flushes
+                                  << " deadline=" << stats.deadline_flushes
+                                  << " forced=" << stats.forced_flushes
+                                  << " stalls=" << stats.stalls
+                                  << " grows=" << stats.batch_grows
+                                  << " shrinks=" << stats.batch_shrinks
+                                  << " batch_size=" << stats.batch_size << std::endl;
+                        const WaitStats_t &waits = state.publisher->getWaitStats();
+                        std::cerr << "Hart " << calculateHartID(vcpu_index) << " chunk waits:"
+                                  << " waits=" << waits.waits
+                                  << " spin_ns=" << waits.spin_time
+                                  << " yield_ns=" << waits.yield_time
+                                  << " block_ns=" << waits.block_time << std::endl;
+                    }
                 };
 
                 /**
@@ -124,10 +421,39 @@ namespace archXplore
                 static auto userExitCallback(int signum) noexcept -> void
                 {
                     // Release publish before exit(Roudi receives runtime close before publisher destruction)
-                    for (auto &publisher : m_event_publishers)
+                    for (HartID_t i = 0; i < m_max_harts; ++i)
                     {
-                        publisher.second.reset();
+                        if (m_vcpu_states[i].trace != nullptr)
+                        {
+                            try
+                            {
+                                m_vcpu_states[i].trace->flush();
+                            }
+                            catch (const std::runtime_error &e)
+                            {
+                                stopTrace(m_vcpu_states[i], e);
+                            }
+                        }
+                        m_vcpu_states[i].publisher.reset();
+                        if (m_vcpu_states[i].bbv_file != nullptr)
+                        {
+                            m_vcpu_states[i].bbv_file->flush();
+                        }
                     }
+                    if (m_trace_writer != nullptr)
+                    {
+                        try
+                        {
+                            m_trace_writer->close();
+                        }
+                        catch (const std::runtime_error &e)
+                        {
+                            std::cerr << "Trace recording failed: " << e.what() << std::endl;
+                        }
+                    }
+                    m_static_publisher.reset();
+                    m_control_listener.reset();
+                    m_control_subscriber.reset();
                     std::exit(signum);
                 };
 
@@ -154,9 +480,14 @@ namespace archXplore
                                     uint64_t a6, uint64_t a7, uint64_t a8) -> void
                 {
                     // Send syscall event
-                    if (m_max_harts > 1)
+                    if (m_max_harts > 1 && m_mode.load(std::memory_order_relaxed) == InstrumentMode_t::FULL)
                     {
-                        m_event_publishers.at(vcpu_index)->publish(true, cpu::ThreadEvent_t::SyscallApiTag, m_event_counters.at(vcpu_index)++, cpu::SyscallAPI_t());
+                        VCPUState_t &state = m_vcpu_states[vcpu_index];
+                        if (m_block_stream && state.pending_block != nullptr)
+                        {
+                            flushBlock(vcpu_index, false);
+                        }
+                        emit(state, true, cpu::ThreadEvent_t::SyscallApiTag, state.event_counter++, cpu::SyscallAPI_t());
                     }
                 };
 
@@ -183,38 +514,54 @@ namespace archXplore
                  */
                 static auto translateBasicBlock(qemu_plugin_id_t id, qemu_plugin_tb *tb) -> void
                 {
+                    if (m_bbv_interval > 0)
+                    {
+                        translateProfile(tb);
+                        return;
+                    }
+                    // Every VCPU polls the requests of the simulator every few blocks
+                    qemu_plugin_register_vcpu_tb_exec_inline_per_vcpu(tb, QEMU_PLUGIN_INLINE_ADD_U64, m_poll_count, 1);
+                    qemu_plugin_register_vcpu_tb_exec_cond_cb(tb, pollRequests, QEMU_PLUGIN_CB_NO_REGS,
+                                                              QEMU_PLUGIN_COND_GE, m_poll_count, REQUEST_POLL_BLOCKS, NULL);
+                    const InstrumentMode_t mode = m_mode.load(std::memory_order_relaxed);
+                    // A window with a budget returns to the previous mode at a fixed instruction count
+                    const uint64_t budget = m_budget.load(std::memory_order_relaxed);
+                    if (budget > 0)
+                    {
+                        if (mode != InstrumentMode_t::COUNT)
+                        {
+                            qemu_plugin_register_vcpu_tb_exec_inline_per_vcpu(tb, QEMU_PLUGIN_INLINE_ADD_U64, m_inst_count,
+                                                                              qemu_plugin_tb_n_insns(tb));
+                        }
+                        qemu_plugin_register_vcpu_tb_exec_cond_cb(tb, budgetExhausted, QEMU_PLUGIN_CB_NO_REGS,
+                                                                  QEMU_PLUGIN_COND_GE, m_inst_count, budget, NULL);
+                    }
+                    switch (mode)
+                    {
+                    case InstrumentMode_t::NONE:
+                        return;
+                    case InstrumentMode_t::COUNT:
+                        translateCountOnly(tb);
+                        return;
+                    default:
+                        break;
+                    }
+                    if (m_block_stream)
+                    {
+                        translateBlockRecord(tb);
+                        return;
+                    }
                     qemu_plugin_insn *insn;
                     for (size_t i = 0; i < qemu_plugin_tb_n_insns(tb); ++i)
                     {
-                        InstCacheEntry_t new_entry;
                         insn = qemu_plugin_tb_get_insn(tb, i);
-                        new_entry.pc = qemu_plugin_insn_vaddr(insn);
-                        new_entry.len = qemu_plugin_insn_size(insn);
-                        switch (new_entry.len)
-                        {
-                        case 1:
-                            new_entry.opcode = *((uint8_t *)qemu_plugin_insn_data(insn));
-                            break;
-                        case 2:
-                            new_entry.opcode = *((uint16_t *)qemu_plugin_insn_data(insn));
-                            break;
-                        case 4:
-                            new_entry.opcode = *((uint32_t *)qemu_plugin_insn_data(insn));
-                            break;
-                        default:
-                            throw "Unknown instruction size!\n";
-                            break;
-                        }
-                        // Insert into cache
-                        {
-                            // Acquire lock for cache
-                            std::unique_lock<std::shared_mutex> lock(m_inst_cache_mutex);
-                            // Insert into cache
-                            m_inst_cache[new_entry.pc] = new_entry;
-                        }
+                        const Addr_t pc = qemu_plugin_insn_vaddr(insn);
+                        const uint8_t len = qemu_plugin_insn_size(insn);
+                        // Allocate descriptor, it lives as long as the plugin
+                        const InstDescriptor_t *desc = m_inst_arena.create(InstDescriptor_t{pc, readOpcode(insn, len), len});
                         // Register instruction execution callback
                         qemu_plugin_register_vcpu_insn_exec_cb(insn, executeInstruction,
-                                                               QEMU_PLUGIN_CB_NO_REGS, (void *)new_entry.pc);
+                                                               QEMU_PLUGIN_CB_NO_REGS, (void *)desc);
 
                         // Register memory access callback
                         qemu_plugin_register_vcpu_mem_cb(insn, memoryAccess,
@@ -223,43 +570,356 @@ namespace archXplore
                 };
 
                 /**
-                 * @brief Execute an instruction
+                 * @brief Read the opcode of a translated instruction
+                 *
+                 * @param insn The translated instruction
+                 * @param len The instruction length in bytes
+                 *
+                 * @return uint32_t
+                 */
+                static auto readOpcode(qemu_plugin_insn *insn, const uint8_t &len) -> uint32_t
+                {
+                    switch (len)
+                    {
+                    case 1:
+                        return *((uint8_t *)qemu_plugin_insn_data(insn));
+                    case 2:
+                        return *((uint16_t *)qemu_plugin_insn_data(insn));
+                    case 4:
+                        return *((uint32_t *)qemu_plugin_insn_data(insn));
+                    default:
+                        throw "Unknown instruction size!\n";
+                    }
+                };
+
+                /**
+                 * @brief Translate a basic block with inline instruction counting only
+                 *
+                 * @param tb The basic block to translate
+                 *
+                 * @return void
+                 */
+                static auto translateCountOnly(qemu_plugin_tb *tb) -> void
+                {
+                    qemu_plugin_register_vcpu_tb_exec_inline_per_vcpu(tb, QEMU_PLUGIN_INLINE_ADD_U64, m_inst_count,
+                                                                      qemu_plugin_tb_n_insns(tb));
+                    if (m_fast_forward_insts > 0 && !m_fast_forward_done.load(std::memory_order_relaxed))
+                    {
+                        qemu_plugin_register_vcpu_tb_exec_cond_cb(tb, fastForwardDone, QEMU_PLUGIN_CB_NO_REGS,
+                                                                  QEMU_PLUGIN_COND_GE, m_inst_count,
+                                                                  m_fast_forward_insts, NULL);
+                    }
+                };
+
+                /**
+                 * @brief A VCPU reached the fast-forward threshold
                  *
                  * @param vcpu_index The index of the VCPU
                  * @param userdata The userdata pointer
                  *
                  * @return void
                  */
-                static auto executeInstruction(unsigned int vcpu_index, void *userdata) -> void
+                static auto fastForwardDone(unsigned int vcpu_index, void *userdata) -> void
+                {
+                    if (!m_fast_forward_done.exchange(true))
+                    {
+                        // Stays pending when another switch is in progress
+                        requestMode(InstrumentMode_t::FULL, 0);
+                        applyRequestedMode(vcpu_index, userdata);
+                    }
+                };
+
+                /**
+                 * @brief A VCPU ran the instruction budget of the current mode
+                 *
+                 * @param vcpu_index The index of the VCPU
+                 * @param userdata The userdata pointer
+                 *
+                 * @return void
+                 */
+                static auto budgetExhausted(unsigned int vcpu_index, void *userdata) -> void
+                {
+                    if (!m_budget_done.exchange(true))
+                    {
+                        // A newer request of the simulator replaces the return
+                        if (m_request_generation.load(std::memory_order_acquire) ==
+                            m_applied_generation.load(std::memory_order_relaxed))
+                        {
+                            requestMode(m_previous_mode.load(), 0);
+                        }
+                        applyRequestedMode(vcpu_index, userdata);
+                    }
+                };
+
+                /**
+                 * @brief Translate a basic block for basic block vector profiling
+                 *
+                 * @param tb The basic block to translate
+                 *
+                 * @return void
+                 */
+                static auto translateProfile(qemu_plugin_tb *tb) -> void
+                {
+                    const Addr_t pc = qemu_plugin_tb_vaddr(tb);
+                    const size_t num_insts = qemu_plugin_tb_n_insns(tb);
+                    BBVEntry_t *entry;
+                    {
+                        std::lock_guard<std::mutex> lock(m_bbv_mutex);
+                        auto &slot = m_bbv_entries[pc];
+                        if (slot == nullptr)
+                        {
+                            // SimPoint block IDs start from 1
+                            slot = m_bbv_arena.create(BBVEntry_t{m_bbv_entries.size(),
+                                                                 qemu_plugin_scoreboard_u64(qemu_plugin_scoreboard_new(sizeof(uint64_t)))});
+                            m_bbv_order.push_back(slot);
+                        }
+                        entry = slot;
+                    }
+                    // Weight blocks by their instruction count
+                    qemu_plugin_register_vcpu_tb_exec_inline_per_vcpu(tb, QEMU_PLUGIN_INLINE_ADD_U64, entry->count, num_insts);
+                    qemu_plugin_register_vcpu_tb_exec_inline_per_vcpu(tb, QEMU_PLUGIN_INLINE_ADD_U64, m_inst_count, num_insts);
+                    qemu_plugin_register_vcpu_tb_exec_cond_cb(tb, dumpBBV, QEMU_PLUGIN_CB_NO_REGS,
+                                                              QEMU_PLUGIN_COND_GE, m_inst_count, m_bbv_interval, NULL);
+                };
+
+                /**
+                 * @brief Write the basic block vector of the finished interval
+                 *
+                 * @param vcpu_index The index of the VCPU
+                 * @param userdata The userdata pointer
+                 *
+                 * @return void
+                 */
+                static auto dumpBBV(unsigned int vcpu_index, void *userdata) -> void
+                {
+                    std::lock_guard<std::mutex> lock(m_bbv_mutex);
+                    std::ofstream &file = *m_vcpu_states[vcpu_index].bbv_file;
+                    file << "T";
+                    for (auto entry : m_bbv_order)
+                    {
+                        const uint64_t count = qemu_plugin_u64_get(entry->count, vcpu_index);
+                        if (count > 0)
+                        {
+                            file << ":" << entry->id << ":" << count << " ";
+                            qemu_plugin_u64_set(entry->count, vcpu_index, 0);
+                        }
+                    }
+                    file << "\n";
+                    qemu_plugin_u64_set(m_inst_count, vcpu_index, 0);
+                };
+
+                /**
+                 * @brief Translate a basic block into a block record
+                 *
+                 * @param tb The basic block to translate
+                 *
+                 * @return void
+                 */
+                static auto translateBlockRecord(qemu_plugin_tb *tb) -> void
+                {
+                    const size_t num_insts = qemu_plugin_tb_n_insns(tb);
+                    InstDescriptor_t *insts = m_inst_arena.createArray(num_insts);
+                    for (size_t i = 0; i < num_insts; ++i)
+                    {
+                        qemu_plugin_insn *insn = qemu_plugin_tb_get_insn(tb, i);
+                        insts[i].pc = qemu_plugin_insn_vaddr(insn);
+                        insts[i].len = qemu_plugin_insn_size(insn);
+                        insts[i].opcode = readOpcode(insn, insts[i].len);
+                        // Memory accesses are attributed to the instruction index within the block
+                        qemu_plugin_register_vcpu_mem_cb(insn, blockMemoryAccess,
+                                                         QEMU_PLUGIN_CB_NO_REGS, QEMU_PLUGIN_MEM_RW, (void *)i);
+                    }
+                    const BlockDescriptor_t *block = m_block_arena.create(m_block_counter++, qemu_plugin_tb_vaddr(tb),
+                                                                          num_insts, insts);
+                    // Queue the definition, it is flushed before the block first executes
+                    {
+                        std::lock_guard<std::mutex> lock(m_shared_resource_mutex);
+                        m_static_publisher->publish(false, cpu::ThreadEvent_t::BlockDefineTag, block->id,
+                                                    cpu::BlockDefine_t{block->id, block->pc, block->num_insts});
+                        for (uint16_t i = 0; i < block->num_insts; ++i)
+                        {
+                            cpu::StaticInst_t inst = {};
+                            inst.pc = insts[i].pc;
+                            inst.opcode = insts[i].opcode;
+                            inst.len = insts[i].len;
+                            m_static_publisher->publish(false, cpu::ThreadEvent_t::InsnTag, block->id, inst);
+                        }
+                        m_unflushed_blocks.push_back(block);
+                    }
+                    // Register block execution callback
+                    qemu_plugin_register_vcpu_tb_exec_cb(tb, executeBlock, QEMU_PLUGIN_CB_NO_REGS, (void *)block);
+                };
+
+                /**
+                 * @brief Send an event to the simulator and to the trace file
+                 *
+                 * @param state The VCPU state
+                 * @param force_publish Publish the chunk now regardless of the flush policy
+                 * @param args Arguments to forward to the event
+                 *
+                 * @return void
+                 */
+                template <typename... Args>
+                static inline auto emit(VCPUState_t &state, const bool &force_publish, Args &&...args) -> void
+                {
+                    if (state.trace != nullptr)
+                    {
+                        try
+                        {
+                            state.trace->record(cpu::ThreadEvent_t(args...));
+                        }
+                        catch (const std::runtime_error &e)
+                        {
+                            stopTrace(state, e);
+                        }
+                    }
+                    if (state.publisher != nullptr)
+                    {
+                        state.publisher->publish(force_publish, std::forward<Args>(args)...);
+                    }
+                };
+
+                /**
+                 * @brief Stop recording the trace of a VCPU after the writer failed
+                 *
+                 * @param state The VCPU state
+                 * @param e The error of the trace writer
+                 *
+                 * @return void
+                 */
+                static auto stopTrace(VCPUState_t &state, const std::runtime_error &e) -> void
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_shared_resource_mutex);
+                        std::cerr << "Trace recording stopped: " << e.what() << std::endl;
+                    }
+                    state.trace.reset();
+                };
+
+                /**
+                 * @brief Flush the queued block definitions to the simulator
+                 *
+                 * @return void
+                 */
+                static auto flushBlockDefinitions() -> void
+                {
+                    std::lock_guard<std::mutex> lock(m_shared_resource_mutex);
+                    m_static_publisher->flush();
+                    for (const BlockDescriptor_t *block : m_unflushed_blocks)
+                    {
+                        block->flushed.store(true, std::memory_order_release);
+                    }
+                    m_unflushed_blocks.clear();
+                };
+
+                /**
+                 * @brief Publish the pending block record of a VCPU
+                 *
+                 * @param vcpu_index The index of the VCPU
+                 * @param is_last Mark the record as the last event of the hart
+                 *
+                 * @return void
+                 */
+                static auto flushBlock(unsigned int vcpu_index, const bool &is_last) -> void
+                {
+                    VCPUState_t &state = m_vcpu_states[vcpu_index];
+                    auto event = cpu::ThreadEvent_t(cpu::ThreadEvent_t::BlockTag, state.event_counter++, state.block_record);
+                    event.is_last = is_last;
+                    state.publisher->publish(is_last, event);
+                    state.pending_block = nullptr;
+                };
+
+                /**
+                 * @brief Execute a basic block
+                 *
+                 * @param vcpu_index The index of the VCPU
+                 * @param userdata Pointer to the block descriptor
+                 *
+                 * @return void
+                 */
+                static auto executeBlock(unsigned int vcpu_index, void *userdata) -> void
+                {
+                    const BlockDescriptor_t &block = *(const BlockDescriptor_t *)userdata;
+                    VCPUState_t &state = m_vcpu_states[vcpu_index];
+                    // The simulator needs the definition before the first record of the block
+                    if (__glibc_unlikely(!block.flushed.load(std::memory_order_acquire)))
+                    {
+                        flushBlockDefinitions();
+                    }
+                    // Memory accesses of the previous block are complete now
+                    if (__glibc_likely(state.pending_block != nullptr))
+                    {
+                        flushBlock(vcpu_index, false);
+                    }
+                    // Open a new record for this block
+                    cpu::BlockEvent_t &record = state.block_record;
+                    record.block_id = block.id;
+                    record.num_mem = 0;
+                    record.has_more = false;
+                    state.pending_block = &block;
+                    state.inst_counter += block.num_insts;
+                };
+
+                /**
+                 * @brief Memory access in block record mode
+                 *
+                 * @param vcpu_index The index of the VCPU
+                 * @param info The memory access information
+                 * @param vaddr The virtual address accessed
+                 * @param userdata Index of the instruction within the block
+                 *
+                 * @return void
+                 */
+                static auto blockMemoryAccess(unsigned int vcpu_index, qemu_plugin_meminfo_t info,
+                                              uint64_t vaddr, void *userdata) -> void
                 {
-                    InstCacheEntry_t inst;
-                    const Addr_t key = (Addr_t)userdata;
-                    // Acquire lock for cache
+                    VCPUState_t &state = m_vcpu_states[vcpu_index];
+                    cpu::BlockEvent_t &record = state.block_record;
+                    if (__glibc_unlikely(record.num_mem == cpu::BlockEvent_t::MAX_MEM_ACCESSES))
                     {
-                        std::shared_lock<std::shared_mutex> lock(m_inst_cache_mutex);
-                        // Lookup in cache
-                        inst = m_inst_cache[key];
+                        // Continue the accesses in a new record of the same block
+                        record.has_more = true;
+                        state.publisher->publish(false, cpu::ThreadEvent_t::BlockTag, state.event_counter++, record);
+                        record.num_mem = 0;
+                        record.has_more = false;
                     }
+                    auto &access = record.mem[record.num_mem++];
+                    access.vaddr = vaddr;
+                    access.index = (uint16_t)(uintptr_t)userdata;
+                    access.size_shift = qemu_plugin_mem_size_shift(info);
+                    access.is_store = qemu_plugin_mem_is_store(info);
+                };
+
+                /**
+                 * @brief Execute an instruction
+                 *
+                 * @param vcpu_index The index of the VCPU
+                 * @param userdata Pointer to the instruction descriptor
+                 *
+                 * @return void
+                 */
+                static auto executeInstruction(unsigned int vcpu_index, void *userdata) -> void
+                {
+                    const InstDescriptor_t &inst = *(const InstDescriptor_t *)userdata;
+                    VCPUState_t &state = m_vcpu_states[vcpu_index];
+                    cpu::StaticInst_t &last_inst = state.last_inst;
 
                     // First time executing instruction
-                    if (__glibc_likely(m_inst_counters.at(vcpu_index) != 0))
+                    if (__glibc_likely(state.inst_pending))
                     {
-                        cpu::StaticInst_t &last_inst = m_last_insts.at(vcpu_index);
                         // Add next pc to last executed instruction
                         last_inst.br_info.target_pc = inst.pc;
-                        if (last_inst.pc != inst.pc + inst.len)
-                        {
-                            last_inst.br_info.redirect = true;
-                        }
+                        last_inst.br_info.redirect = (last_inst.pc + last_inst.len != inst.pc);
                         // Send instruction
-                        m_event_publishers.at(vcpu_index)->publish(false, cpu::ThreadEvent_t::InsnTag, m_event_counters.at(vcpu_index)++, last_inst);
+                        emit(state, false, cpu::ThreadEvent_t::InsnTag, state.event_counter++, last_inst);
                     }
                     // Update last executed instruction
-                    cpu::StaticInst_t &cur_inst = m_last_insts.at(vcpu_index);
-                    cur_inst.uid = m_inst_counters.at(vcpu_index)++;
+                    cpu::StaticInst_t &cur_inst = last_inst;
+                    cur_inst.uid = state.inst_counter++;
                     cur_inst.pc = inst.pc;
                     cur_inst.opcode = inst.opcode;
                     cur_inst.len = inst.len;
+                    state.inst_pending = true;
                 };
 
                 /**
@@ -275,13 +935,15 @@ namespace archXplore
                 static auto memoryAccess(unsigned int vcpu_index, qemu_plugin_meminfo_t info,
                                          uint64_t vaddr, void *userdata) -> void
                 {
-                    cpu::StaticInst_t &cur_inst = m_last_insts.at(vcpu_index);
+                    cpu::StaticInst_t &cur_inst = m_vcpu_states[vcpu_index].last_inst;
                     cur_inst.mem_info.vaddr = vaddr;
                     cur_inst.mem_info.len = qemu_plugin_mem_size_shift(info);
                     cur_inst.mem_info.is_store = qemu_plugin_mem_is_store(info);
                 };
 
             public:
+                // QEMU plugin ID
+                static qemu_plugin_id_t m_plugin_id;
                 // Application name
                 static std::string m_app_name;
                 // Runtime name
@@ -292,22 +954,83 @@ namespace archXplore
                 static HartID_t m_boot_hart;
                 // Maximum number of harts
                 static HartID_t m_max_harts;
+                // Send basic block records instead of instructions
+                static bool m_block_stream;
+                // Instructions to execute before full instrumentation starts
+                static uint64_t m_fast_forward_insts;
+                // Latency bound of buffered events in microseconds, zero disables the bound
+                static uint64_t m_flush_latency;
+                // Report the flush policy decisions at thread exit
+                static bool m_flush_stats;
+                // Delta encode the event stream
+                static bool m_compress_events;
+                // How publishers wait for free chunks
+                static WaitPolicy_t m_wait_policy;
+                // Trace file path, recording only when not empty
+                static std::string m_trace_file;
+                // Record the trace without publishing to the simulator
+                static bool m_trace_only;
+                // Trace file writer
+                static std::unique_ptr<TraceWriter> m_trace_writer;
+                // Basic block vector interval, profiling only when non-zero
+                static uint64_t m_bbv_interval;
+                // Basic block vector output file prefix
+                static std::string m_bbv_file;
+                // Current instrumentation mode
+                static std::atomic<InstrumentMode_t> m_mode;
+                // Mode requested by the simulator
+                static std::atomic<InstrumentMode_t> m_requested_mode;
+                // Mode before the last switch
+                static std::atomic<InstrumentMode_t> m_previous_mode;
+                // Instruction budget of the current mode, zero when unbounded
+                static std::atomic<uint64_t> m_budget;
+                // Per-VCPU blocks since the last poll of the simulator requests
+                static qemu_plugin_scoreboard *m_poll_scoreboard;
+                static qemu_plugin_u64 m_poll_count;
+                // Per-VCPU instructions run without events since the last switch
+                static qemu_plugin_scoreboard *m_inst_scoreboard;
+                static qemu_plugin_u64 m_inst_count;
+                // State of each VCPU, indexed by VCPU index, allocated at install
+                static std::unique_ptr<VCPUState_t[]> m_vcpu_states;
 
             private:
                 // Shared Resource Lock
                 static std::mutex m_shared_resource_mutex;
-                // Instruction counter for each VCPU
-                static std::unordered_map<HartID_t, EventID_t> m_inst_counters;
-                // Event counter for each VCPU
-                static std::unordered_map<HartID_t, EventID_t> m_event_counters;
-                // Last executed instructions for each VCPU
-                static std::unordered_map<HartID_t, cpu::StaticInst_t> m_last_insts;
-                // Event publisher
-                static std::unordered_map<HartID_t, std::unique_ptr<EventPublisher>> m_event_publishers;
-                // Instruction cache
-                static InstCache_t m_inst_cache;
-                // Mutex for instruction cache
-                static std::shared_mutex m_inst_cache_mutex;
+                // Fast-forward threshold was reached
+                static std::atomic<bool> m_fast_forward_done;
+                // A mode switch is being applied
+                static std::atomic<bool> m_switch_in_progress;
+                // Request lock, guards the requested mode and budget
+                static std::mutex m_request_mutex;
+                // Instruction budget requested with the mode
+                static uint64_t m_requested_budget;
+                // Requests made so far
+                static std::atomic<uint64_t> m_request_generation;
+                // Requests seen by the last switch
+                static std::atomic<uint64_t> m_applied_generation;
+                // The budget of the current mode ran out
+                static std::atomic<bool> m_budget_done;
+                // Basic block vector lock
+                static std::mutex m_bbv_mutex;
+                // Basic block vector entries by block start address
+                static std::unordered_map<Addr_t, BBVEntry_t *> m_bbv_entries;
+                // Basic block vector entries in ID order
+                static std::vector<BBVEntry_t *> m_bbv_order;
+                // Basic block vector entry storage
+                static utils::Arena<BBVEntry_t> m_bbv_arena;
+                // Control requests of the simulator
+                static std::unique_ptr<iox::popo::Subscriber<ControlMessage_t>> m_control_subscriber;
+                static std::unique_ptr<iox::popo::Listener> m_control_listener;
+                // Static code publisher, guarded by the shared resource lock
+                static std::unique_ptr<EventPublisher> m_static_publisher;
+                // Instruction descriptors
+                static InstArena_t m_inst_arena;
+                // Block descriptors
+                static BlockArena_t m_block_arena;
+                // Block ID allocator
+                static std::atomic<BlockID_t> m_block_counter;
+                // Blocks whose definitions are not flushed yet, guarded by the shared resource lock
+                static std::vector<const BlockDescriptor_t *> m_unflushed_blocks;
             };
 
         } // namespace qemu
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <elf.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "iss/riscv/RiscvMemory.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+        namespace riscv
+        {
+
+            /*
+             * @brief Layout of a loaded executable
+             */
+            struct ElfImage_t
+            {
+                // Entry point
+                Addr_t entry = 0;
+                // Address of the program headers in guest memory
+                Addr_t phdr = 0;
+                // Number of program headers
+                uint64_t phnum = 0;
+                // Size of a program header
+                uint64_t phent = 0;
+                // End of the highest loaded segment, page aligned
+                Addr_t brk = 0;
+            };
+
+            /**
+             * @brief Load a statically linked RISC-V ELF64 executable
+             * @param path Path of the executable
+             * @param memory Guest memory receiving the segments
+             * @return Layout of the loaded executable
+             */
+            inline auto loadElf(const std::string &path, RiscvMemory &memory) -> ElfImage_t
+            {
+                std::ifstream file(path, std::ios::binary);
+                if (!file)
+                {
+                    throw std::runtime_error("Unable to open executable " + path);
+                }
+                std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+                if (bytes.size() < sizeof(Elf64_Ehdr))
+                {
+                    throw std::runtime_error(path + " is not an ELF file");
+                }
+                Elf64_Ehdr ehdr;
+                std::memcpy(&ehdr, bytes.data(), sizeof(ehdr));
+                if (std::memcmp(ehdr.e_ident, ELFMAG, SELFMAG) != 0 || ehdr.e_ident[EI_CLASS] != ELFCLASS64 ||
+                    ehdr.e_ident[EI_DATA] != ELFDATA2LSB || ehdr.e_machine != EM_RISCV)
+                {
+                    throw std::runtime_error(path + " is not a little-endian RV64 ELF file");
+                }
+                if (ehdr.e_type != ET_EXEC)
+                {
+                    throw std::runtime_error(path + " is not a statically linked executable");
+                }
+                if (ehdr.e_phoff + uint64_t(ehdr.e_phnum) * sizeof(Elf64_Phdr) > bytes.size())
+                {
+                    throw std::runtime_error(path + " has truncated program headers");
+                }
+
+                ElfImage_t image;
+                image.entry = ehdr.e_entry;
+                image.phnum = ehdr.e_phnum;
+                image.phent = sizeof(Elf64_Phdr);
+                for (uint16_t i = 0; i < ehdr.e_phnum; ++i)
+                {
+                    Elf64_Phdr phdr;
+                    std::memcpy(&phdr, bytes.data() + ehdr.e_phoff + i * sizeof(Elf64_Phdr), sizeof(phdr));
+                    if (phdr.p_type == PT_PHDR)
+                    {
+                        image.phdr = phdr.p_vaddr;
+                    }
+                    if (phdr.p_type != PT_LOAD)
+                    {
+                        continue;
+                    }
+                    if (phdr.p_offset + phdr.p_filesz > bytes.size() || phdr.p_filesz > phdr.p_memsz)
+                    {
+                        throw std::runtime_error(path + " has a truncated segment");
+                    }
+                    // The rest of the segment is bss, pages are zero-filled already
+                    memory.write(phdr.p_vaddr, bytes.data() + phdr.p_offset, phdr.p_filesz);
+                    // The program headers are mapped by the segment covering them
+                    if (image.phdr == 0 && phdr.p_offset <= ehdr.e_phoff && ehdr.e_phoff < phdr.p_offset + phdr.p_filesz)
+                    {
+                        image.phdr = phdr.p_vaddr + (ehdr.e_phoff - phdr.p_offset);
+                    }
+                    const Addr_t end = (phdr.p_vaddr + phdr.p_memsz + RiscvMemory::PAGE_MASK) & ~RiscvMemory::PAGE_MASK;
+                    image.brk = std::max(image.brk, end);
+                }
+                return image;
+            };
+
+        } // namespace riscv
+    } // namespace iss
+} // namespace archXplore
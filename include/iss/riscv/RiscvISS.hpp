@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+#include "iss/AbstractISS.hpp"
+#include "iss/riscv/RiscvInterpreter.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+        namespace riscv
+        {
+
+            class RiscvISS : public AbstractISS
+            {
+            public:
+
+                inline auto initCPUState() -> void override;
+
+                inline auto generateFetchRequest(const Addr_t& addr, const size_t& fetch_size) -> void override;
+
+                inline auto processFetchResponse(const uint8_t* data) -> FetchGroup_t override;
+
+                RiscvISS();
+
+                ~RiscvISS();
+
+            protected:
+
+                inline auto openInterpreter() -> RiscvInterpreter&;
+
+                inline auto finish() -> void;
+
+                inline auto stop(const std::runtime_error& e) -> void;
+
+                inline auto wakeUpMonitor() -> void override;
+
+                inline auto initialize() -> void override;
+
+            private:
+
+                // Instructions of the pending fetch
+                FetchPackage m_fetch_package;
+
+                // A fetch request waits for its response
+                bool m_fetch_pending = false;
+
+                // Interpreter running the process of this hart
+                std::unique_ptr<RiscvInterpreter> m_interpreter;
+
+                // Executed instruction that did not fit into the last fetch package
+                std::optional<cpu::StaticInst_t> m_held_inst;
+
+                // Outcome of the held instruction
+                StepResult_t m_held_result = StepResult_t::NORMAL;
+
+            };
+        }
+    } // namespace iss
+} // namespace archXplore
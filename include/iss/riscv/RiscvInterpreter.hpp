@@ -0,0 +1,991 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cpu/StaticInst.hpp"
+#include "iss/riscv/ElfLoader.hpp"
+#include "iss/riscv/RiscvMemory.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+        namespace riscv
+        {
+
+            /*
+             * @brief Outcome of an executed instruction
+             */
+            enum class StepResult_t : uint8_t
+            {
+                // Plain instruction
+                NORMAL,
+                // The instruction was a proxied syscall
+                SYSCALL,
+                // The process exited
+                EXIT
+            };
+
+            /**
+             * @brief RV64IMAC user-mode interpreter
+             *
+             * Runs a statically linked executable in process. Compressed
+             * instructions are expanded to their 32-bit equivalents before
+             * execution. Syscalls are proxied to the host, a handful are
+             * emulated and the rest fail with ENOSYS. Every executed instruction
+             * is described as a StaticInst_t.
+             */
+            class RiscvInterpreter
+            {
+            public:
+                // Top of the guest stack
+                static constexpr Addr_t STACK_TOP = 0x3ffffff000;
+
+                // First address handed out by mmap
+                static constexpr Addr_t MMAP_BASE = 0x2000000000;
+
+                RiscvInterpreter(const RiscvInterpreter &rhs) = delete;
+                RiscvInterpreter &operator=(const RiscvInterpreter &rhs) = delete;
+
+                /**
+                 * @brief Constructor
+                 * @param executable Path of the executable
+                 * @param arguments Command line arguments, without the executable
+                 */
+                RiscvInterpreter(const std::string &executable, const std::vector<std::string> &arguments)
+                {
+                    m_image = loadElf(executable, m_memory);
+                    m_pc = m_image.entry;
+                    m_brk_base = m_brk = m_image.brk;
+                    std::vector<std::string> argv{executable};
+                    argv.insert(argv.end(), arguments.begin(), arguments.end());
+                    setupStack(argv);
+                };
+
+                /**
+                 * @brief Get the pc of the next instruction
+                 * @return The pc
+                 */
+                inline auto pc() const -> Addr_t
+                {
+                    return m_pc;
+                };
+
+                /**
+                 * @brief Check whether the process exited
+                 * @return True after exit or exit_group
+                 */
+                inline auto exited() const -> bool
+                {
+                    return m_exited;
+                };
+
+                /**
+                 * @brief Get the exit code
+                 * @return The exit code of the process
+                 */
+                inline auto exitCode() const -> int64_t
+                {
+                    return m_exit_code;
+                };
+
+                /**
+                 * @brief Execute one instruction
+                 * @param inst Filled with the description of the instruction
+                 * @return Outcome of the instruction
+                 */
+                inline auto step(cpu::StaticInst_t &inst) -> StepResult_t
+                {
+                    inst = cpu::StaticInst_t{};
+                    inst.uid = m_inst_count++;
+                    inst.pc = m_pc;
+                    const uint16_t half = m_memory.load<uint16_t>(m_pc);
+                    uint32_t word;
+                    if ((half & 3) == 3)
+                    {
+                        word = m_memory.load<uint32_t>(m_pc);
+                        inst.opcode = word;
+                        inst.len = 4;
+                    }
+                    else
+                    {
+                        word = expandCompressed(half);
+                        inst.opcode = half;
+                        inst.len = 2;
+                    }
+                    const StepResult_t result = execute(inst, word);
+                    inst.br_info.redirect = (inst.br_info.target_pc != inst.pc + inst.len);
+                    m_pc = inst.br_info.target_pc;
+                    return result;
+                };
+
+            private:
+                enum Opcode_t : uint32_t
+                {
+                    OP_LOAD = 0x03,
+                    OP_MISC_MEM = 0x0f,
+                    OP_IMM = 0x13,
+                    OP_AUIPC = 0x17,
+                    OP_IMM32 = 0x1b,
+                    OP_STORE = 0x23,
+                    OP_AMO = 0x2f,
+                    OP_OP = 0x33,
+                    OP_LUI = 0x37,
+                    OP_OP32 = 0x3b,
+                    OP_BRANCH = 0x63,
+                    OP_JALR = 0x67,
+                    OP_JAL = 0x6f,
+                    OP_SYSTEM = 0x73
+                };
+
+                static inline auto sext(const uint64_t &value, const unsigned &bits) -> int64_t
+                {
+                    return int64_t(value << (64 - bits)) >> (64 - bits);
+                };
+
+                static inline auto gpr(const uint32_t &id) -> cpu::RegisterInfo_t
+                {
+                    return cpu::RegisterInfo_t{id == 0 ? cpu::REG_TYPE_NONE : cpu::REG_TYPE_GPR, uint8_t(id)};
+                };
+
+                // 32-bit encoders used to expand compressed instructions
+                static inline auto encR(uint32_t f7, uint32_t rs2, uint32_t rs1, uint32_t f3, uint32_t rd, uint32_t op) -> uint32_t
+                {
+                    return f7 << 25 | rs2 << 20 | rs1 << 15 | f3 << 12 | rd << 7 | op;
+                };
+
+                static inline auto encI(int64_t imm, uint32_t rs1, uint32_t f3, uint32_t rd, uint32_t op) -> uint32_t
+                {
+                    return uint32_t(imm & 0xfff) << 20 | rs1 << 15 | f3 << 12 | rd << 7 | op;
+                };
+
+                static inline auto encS(int64_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3, uint32_t op) -> uint32_t
+                {
+                    return uint32_t((imm >> 5) & 0x7f) << 25 | rs2 << 20 | rs1 << 15 | f3 << 12 | uint32_t(imm & 0x1f) << 7 | op;
+                };
+
+                static inline auto encB(int64_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3, uint32_t op) -> uint32_t
+                {
+                    return uint32_t((imm >> 12) & 1) << 31 | uint32_t((imm >> 5) & 0x3f) << 25 | rs2 << 20 | rs1 << 15 |
+                           f3 << 12 | uint32_t((imm >> 1) & 0xf) << 8 | uint32_t((imm >> 11) & 1) << 7 | op;
+                };
+
+                static inline auto encU(int64_t imm, uint32_t rd, uint32_t op) -> uint32_t
+                {
+                    return uint32_t(imm & 0xfffff000) | rd << 7 | op;
+                };
+
+                static inline auto encJ(int64_t imm, uint32_t rd, uint32_t op) -> uint32_t
+                {
+                    return uint32_t((imm >> 20) & 1) << 31 | uint32_t((imm >> 1) & 0x3ff) << 21 |
+                           uint32_t((imm >> 11) & 1) << 20 | uint32_t((imm >> 12) & 0xff) << 12 | rd << 7 | op;
+                };
+
+                /**
+                 * @brief Expand a compressed instruction
+                 * @param c The 16-bit instruction
+                 * @return The equivalent 32-bit instruction
+                 */
+                inline auto expandCompressed(const uint32_t &c) -> uint32_t
+                {
+                    const uint32_t f3 = c >> 13;
+                    const uint32_t rd = (c >> 7) & 31;
+                    const uint32_t rs2 = (c >> 2) & 31;
+                    const uint32_t rdp = 8 + ((c >> 2) & 7);
+                    const uint32_t rs1p = 8 + ((c >> 7) & 7);
+                    const int64_t imm6 = sext(((c >> 7) & 0x20) | ((c >> 2) & 0x1f), 6);
+                    switch (c & 3)
+                    {
+                    case 0:
+                        switch (f3)
+                        {
+                        case 0: // c.addi4spn
+                        {
+                            const uint32_t imm = ((c >> 7) & 0x30) | ((c >> 1) & 0x3c0) | ((c >> 4) & 4) | ((c >> 2) & 8);
+                            if (imm == 0)
+                            {
+                                break;
+                            }
+                            return encI(imm, 2, 0, rdp, OP_IMM);
+                        }
+                        case 2: // c.lw
+                            return encI(((c >> 7) & 0x38) | ((c >> 4) & 4) | ((c << 1) & 0x40), rs1p, 2, rdp, OP_LOAD);
+                        case 3: // c.ld
+                            return encI(((c >> 7) & 0x38) | ((c << 1) & 0xc0), rs1p, 3, rdp, OP_LOAD);
+                        case 6: // c.sw
+                            return encS(((c >> 7) & 0x38) | ((c >> 4) & 4) | ((c << 1) & 0x40), rdp, rs1p, 2, OP_STORE);
+                        case 7: // c.sd
+                            return encS(((c >> 7) & 0x38) | ((c << 1) & 0xc0), rdp, rs1p, 3, OP_STORE);
+                        default:
+                            break;
+                        }
+                        break;
+                    case 1:
+                        switch (f3)
+                        {
+                        case 0: // c.addi, c.nop
+                            return encI(imm6, rd, 0, rd, OP_IMM);
+                        case 1: // c.addiw
+                            if (rd == 0)
+                            {
+                                break;
+                            }
+                            return encI(imm6, rd, 0, rd, OP_IMM32);
+                        case 2: // c.li
+                            return encI(imm6, 0, 0, rd, OP_IMM);
+                        case 3:
+                            if (rd == 2) // c.addi16sp
+                            {
+                                const int64_t imm = sext(((c >> 3) & 0x200) | ((c >> 2) & 0x10) | ((c << 1) & 0x40) |
+                                                             ((c << 4) & 0x180) | ((c << 3) & 0x20),
+                                                         10);
+                                if (imm == 0)
+                                {
+                                    break;
+                                }
+                                return encI(imm, 2, 0, 2, OP_IMM);
+                            }
+                            else // c.lui
+                            {
+                                const int64_t imm = sext(((c << 5) & 0x20000) | ((c << 10) & 0x1f000), 18);
+                                if (imm == 0 || rd == 0)
+                                {
+                                    break;
+                                }
+                                return encU(imm, rd, OP_LUI);
+                            }
+                        case 4:
+                        {
+                            const uint32_t shamt = ((c >> 7) & 0x20) | ((c >> 2) & 0x1f);
+                            switch ((c >> 10) & 3)
+                            {
+                            case 0: // c.srli
+                                return encI(shamt, rs1p, 5, rs1p, OP_IMM);
+                            case 1: // c.srai
+                                return encI(0x400 | shamt, rs1p, 5, rs1p, OP_IMM);
+                            case 2: // c.andi
+                                return encI(imm6, rs1p, 7, rs1p, OP_IMM);
+                            default:
+                            {
+                                static constexpr uint32_t f3_of[4] = {0, 4, 6, 7};
+                                const uint32_t f = (c >> 5) & 3;
+                                if ((c >> 12) & 1)
+                                {
+                                    if (f >= 2)
+                                    {
+                                        break;
+                                    }
+                                    // c.subw, c.addw
+                                    return encR(f == 0 ? 0x20 : 0, rdp, rs1p, 0, rs1p, OP_OP32);
+                                }
+                                // c.sub, c.xor, c.or, c.and
+                                return encR(f == 0 ? 0x20 : 0, rdp, rs1p, f3_of[f], rs1p, OP_OP);
+                            }
+                            }
+                            break;
+                        }
+                        case 5: // c.j
+                        {
+                            const int64_t imm = sext(((c >> 1) & 0x800) | ((c >> 7) & 0x10) | ((c >> 1) & 0x300) |
+                                                         ((c << 2) & 0x400) | ((c >> 1) & 0x40) | ((c << 1) & 0x80) |
+                                                         ((c >> 2) & 0xe) | ((c << 3) & 0x20),
+                                                     12);
+                            return encJ(imm, 0, OP_JAL);
+                        }
+                        default: // c.beqz, c.bnez
+                        {
+                            const int64_t imm = sext(((c >> 4) & 0x100) | ((c >> 7) & 0x18) | ((c << 1) & 0xc0) |
+                                                         ((c >> 2) & 6) | ((c << 3) & 0x20),
+                                                     9);
+                            return encB(imm, 0, rs1p, f3 == 6 ? 0 : 1, OP_BRANCH);
+                        }
+                        }
+                        break;
+                    case 2:
+                        switch (f3)
+                        {
+                        case 0: // c.slli
+                            return encI(((c >> 7) & 0x20) | ((c >> 2) & 0x1f), rd, 1, rd, OP_IMM);
+                        case 2: // c.lwsp
+                            if (rd == 0)
+                            {
+                                break;
+                            }
+                            return encI(((c >> 7) & 0x20) | ((c >> 2) & 0x1c) | ((c << 4) & 0xc0), 2, 2, rd, OP_LOAD);
+                        case 3: // c.ldsp
+                            if (rd == 0)
+                            {
+                                break;
+                            }
+                            return encI(((c >> 7) & 0x20) | ((c >> 2) & 0x18) | ((c << 4) & 0x1c0), 2, 3, rd, OP_LOAD);
+                        case 4:
+                            if (((c >> 12) & 1) == 0)
+                            {
+                                if (rs2 == 0) // c.jr
+                                {
+                                    if (rd == 0)
+                                    {
+                                        break;
+                                    }
+                                    return encI(0, rd, 0, 0, OP_JALR);
+                                }
+                                // c.mv
+                                return encR(0, rs2, 0, 0, rd, OP_OP);
+                            }
+                            if (rd == 0 && rs2 == 0) // c.ebreak
+                            {
+                                return 0x00100073;
+                            }
+                            if (rs2 == 0) // c.jalr
+                            {
+                                return encI(0, rd, 0, 1, OP_JALR);
+                            }
+                            // c.add
+                            return encR(0, rs2, rd, 0, rd, OP_OP);
+                        case 6: // c.swsp
+                            return encS(((c >> 7) & 0x3c) | ((c >> 1) & 0xc0), rs2, 2, 2, OP_STORE);
+                        case 7: // c.sdsp
+                            return encS(((c >> 7) & 0x38) | ((c >> 1) & 0x1c0), rs2, 2, 3, OP_STORE);
+                        default:
+                            break;
+                        }
+                        break;
+                    default:
+                        break;
+                    }
+                    illegal(c);
+                    return 0;
+                };
+
+                /**
+                 * @brief Execute a 32-bit instruction
+                 * @param inst Description of the instruction, pc and length are set
+                 * @param w The instruction
+                 * @return Outcome of the instruction
+                 */
+                inline auto execute(cpu::StaticInst_t &inst, const uint32_t &w) -> StepResult_t
+                {
+                    const uint32_t rd = (w >> 7) & 31;
+                    const uint32_t f3 = (w >> 12) & 7;
+                    const uint32_t rs1 = (w >> 15) & 31;
+                    const uint32_t rs2 = (w >> 20) & 31;
+                    const uint32_t f7 = w >> 25;
+                    const uint64_t a = m_x[rs1];
+                    const uint64_t b = m_x[rs2];
+                    const int64_t imm_i = int64_t(int32_t(w)) >> 20;
+                    Addr_t next_pc = inst.pc + inst.len;
+                    uint64_t result = 0;
+                    bool writes_rd = true;
+                    StepResult_t outcome = StepResult_t::NORMAL;
+                    inst.func_info = cpu::TYPE_ALU;
+                    inst.src_reg1 = gpr(rs1);
+                    switch (w & 0x7f)
+                    {
+                    case OP_LUI:
+                        inst.src_reg1 = gpr(0);
+                        result = int64_t(int32_t(w & 0xfffff000));
+                        break;
+                    case OP_AUIPC:
+                        inst.src_reg1 = gpr(0);
+                        result = inst.pc + int64_t(int32_t(w & 0xfffff000));
+                        break;
+                    case OP_JAL:
+                    {
+                        inst.src_reg1 = gpr(0);
+                        const int64_t imm = sext(((w >> 11) & 0x100000) | (w & 0xff000) | ((w >> 9) & 0x800) | ((w >> 20) & 0x7fe), 21);
+                        result = next_pc;
+                        next_pc = inst.pc + imm;
+                        inst.func_info = (rd == 1 || rd == 5) ? cpu::TYPE_CALL : cpu::TYPE_JUMP;
+                        break;
+                    }
+                    case OP_JALR:
+                        result = next_pc;
+                        next_pc = (a + imm_i) & ~Addr_t(1);
+                        if (rd == 1 || rd == 5)
+                        {
+                            inst.func_info = cpu::TYPE_CALL;
+                        }
+                        else if (rd == 0 && (rs1 == 1 || rs1 == 5))
+                        {
+                            inst.func_info = cpu::TYPE_RETURN;
+                        }
+                        else
+                        {
+                            inst.func_info = cpu::TYPE_JUMP_REG;
+                        }
+                        break;
+                    case OP_BRANCH:
+                    {
+                        inst.src_reg2 = gpr(rs2);
+                        writes_rd = false;
+                        inst.func_info = cpu::TYPE_BRANCH;
+                        bool taken;
+                        switch (f3)
+                        {
+                        case 0: taken = (a == b); break;
+                        case 1: taken = (a != b); break;
+                        case 4: taken = (int64_t(a) < int64_t(b)); break;
+                        case 5: taken = (int64_t(a) >= int64_t(b)); break;
+                        case 6: taken = (a < b); break;
+                        case 7: taken = (a >= b); break;
+                        default: illegal(w); taken = false;
+                        }
+                        if (taken)
+                        {
+                            next_pc = inst.pc + sext(((w >> 19) & 0x1000) | ((w << 4) & 0x800) | ((w >> 20) & 0x7e0) | ((w >> 7) & 0x1e), 13);
+                        }
+                        break;
+                    }
+                    case OP_LOAD:
+                    {
+                        const Addr_t addr = a + imm_i;
+                        inst.func_info = cpu::TYPE_LOAD;
+                        inst.mem_info = cpu::MemoryInfo_t{addr, uint8_t(f3 & 3), false};
+                        switch (f3)
+                        {
+                        case 0: result = int64_t(m_memory.load<int8_t>(addr)); break;
+                        case 1: result = int64_t(m_memory.load<int16_t>(addr)); break;
+                        case 2: result = int64_t(m_memory.load<int32_t>(addr)); break;
+                        case 3: result = m_memory.load<uint64_t>(addr); break;
+                        case 4: result = m_memory.load<uint8_t>(addr); break;
+                        case 5: result = m_memory.load<uint16_t>(addr); break;
+                        case 6: result = m_memory.load<uint32_t>(addr); break;
+                        default: illegal(w);
+                        }
+                        break;
+                    }
+                    case OP_STORE:
+                    {
+                        const Addr_t addr = a + ((int64_t(int32_t(w)) >> 25 << 5) | ((w >> 7) & 31));
+                        inst.src_reg2 = gpr(rs2);
+                        writes_rd = false;
+                        inst.func_info = cpu::TYPE_STORE;
+                        inst.mem_info = cpu::MemoryInfo_t{addr, uint8_t(f3), true};
+                        switch (f3)
+                        {
+                        case 0: m_memory.store<uint8_t>(addr, b); break;
+                        case 1: m_memory.store<uint16_t>(addr, b); break;
+                        case 2: m_memory.store<uint32_t>(addr, b); break;
+                        case 3: m_memory.store<uint64_t>(addr, b); break;
+                        default: illegal(w);
+                        }
+                        break;
+                    }
+                    case OP_IMM:
+                        switch (f3)
+                        {
+                        case 0: result = a + imm_i; break;
+                        case 1: result = a << (imm_i & 63); break;
+                        case 2: result = int64_t(a) < imm_i; break;
+                        case 3: result = a < uint64_t(imm_i); break;
+                        case 4: result = a ^ imm_i; break;
+                        case 5: result = (w >> 30) & 1 ? uint64_t(int64_t(a) >> (imm_i & 63)) : a >> (imm_i & 63); break;
+                        case 6: result = a | imm_i; break;
+                        default: result = a & imm_i; break;
+                        }
+                        break;
+                    case OP_IMM32:
+                        switch (f3)
+                        {
+                        case 0: result = int64_t(int32_t(a + imm_i)); break;
+                        case 1: result = int64_t(int32_t(uint32_t(a) << (imm_i & 31))); break;
+                        case 5:
+                            result = (w >> 30) & 1 ? int64_t(int32_t(a) >> (imm_i & 31))
+                                                   : int64_t(int32_t(uint32_t(a) >> (imm_i & 31)));
+                            break;
+                        default: illegal(w);
+                        }
+                        break;
+                    case OP_OP:
+                        inst.src_reg2 = gpr(rs2);
+                        result = f7 == 1 ? mulDiv(f3, a, b) : alu(f3, f7, a, b);
+                        break;
+                    case OP_OP32:
+                        inst.src_reg2 = gpr(rs2);
+                        result = f7 == 1 ? mulDiv32(f3, a, b) : alu32(w, f3, f7, a, b);
+                        break;
+                    case OP_AMO:
+                        inst.src_reg2 = gpr(rs2);
+                        result = amo(inst, w, f3, a, b);
+                        break;
+                    case OP_MISC_MEM:
+                        // Single hart, fences order nothing
+                        writes_rd = false;
+                        inst.func_info = cpu::TYPE_SYSTEM;
+                        break;
+                    case OP_SYSTEM:
+                        inst.func_info = cpu::TYPE_SYSTEM;
+                        if (f3 == 0)
+                        {
+                            writes_rd = false;
+                            if (w == 0x00000073)
+                            {
+                                outcome = syscall();
+                            }
+                            else if (w == 0x00100073)
+                            {
+                                fault("ebreak");
+                            }
+                            // wfi and fences are no-ops in user mode
+                        }
+                        else
+                        {
+                            // Counters read the retired instruction count, other CSRs read zero
+                            const uint32_t csr = w >> 20;
+                            result = (csr >= 0xc00 && csr <= 0xc02) ? m_inst_count : 0;
+                        }
+                        break;
+                    default:
+                        illegal(w);
+                    }
+                    if (writes_rd && rd != 0)
+                    {
+                        m_x[rd] = result;
+                        inst.dst_reg = gpr(rd);
+                    }
+                    inst.br_info.target_pc = next_pc;
+                    return outcome;
+                };
+
+                inline auto alu(const uint32_t &f3, const uint32_t &f7, const uint64_t &a, const uint64_t &b) -> uint64_t
+                {
+                    switch (f3)
+                    {
+                    case 0: return f7 == 0x20 ? a - b : a + b;
+                    case 1: return a << (b & 63);
+                    case 2: return int64_t(a) < int64_t(b);
+                    case 3: return a < b;
+                    case 4: return a ^ b;
+                    case 5: return f7 == 0x20 ? uint64_t(int64_t(a) >> (b & 63)) : a >> (b & 63);
+                    case 6: return a | b;
+                    default: return a & b;
+                    }
+                };
+
+                inline auto alu32(const uint32_t &w, const uint32_t &f3, const uint32_t &f7, const uint64_t &a, const uint64_t &b) -> uint64_t
+                {
+                    switch (f3)
+                    {
+                    case 0: return int64_t(int32_t(f7 == 0x20 ? a - b : a + b));
+                    case 1: return int64_t(int32_t(uint32_t(a) << (b & 31)));
+                    case 5:
+                        return f7 == 0x20 ? int64_t(int32_t(a) >> (b & 31)) : int64_t(int32_t(uint32_t(a) >> (b & 31)));
+                    default: illegal(w); return 0;
+                    }
+                };
+
+                inline auto mulDiv(const uint32_t &f3, const uint64_t &a, const uint64_t &b) -> uint64_t
+                {
+                    const int64_t sa = a, sb = b;
+                    switch (f3)
+                    {
+                    case 0: return a * b;
+                    case 1: return uint64_t((__int128(sa) * __int128(sb)) >> 64);
+                    case 2: return uint64_t((__int128(sa) * __int128(static_cast<unsigned __int128>(b))) >> 64);
+                    case 3: return uint64_t((static_cast<unsigned __int128>(a) * b) >> 64);
+                    case 4: return b == 0 ? ~uint64_t(0) : (sa == INT64_MIN && sb == -1) ? a : uint64_t(sa / sb);
+                    case 5: return b == 0 ? ~uint64_t(0) : a / b;
+                    case 6: return b == 0 ? a : (sa == INT64_MIN && sb == -1) ? 0 : uint64_t(sa % sb);
+                    default: return b == 0 ? a : a % b;
+                    }
+                };
+
+                inline auto mulDiv32(const uint32_t &f3, const uint64_t &a, const uint64_t &b) -> uint64_t
+                {
+                    const int32_t sa = a, sb = b;
+                    const uint32_t ua = a, ub = b;
+                    switch (f3)
+                    {
+                    case 0: return int64_t(int32_t(ua * ub));
+                    case 4: return int64_t(sb == 0 ? -1 : (sa == INT32_MIN && sb == -1) ? sa : sa / sb);
+                    case 5: return int64_t(int32_t(ub == 0 ? ~uint32_t(0) : ua / ub));
+                    case 6: return int64_t(sb == 0 ? sa : (sa == INT32_MIN && sb == -1) ? 0 : sa % sb);
+                    case 7: return int64_t(int32_t(ub == 0 ? ua : ua % ub));
+                    default: illegal(0x3b | f3 << 12 | 1 << 25); return 0;
+                    }
+                };
+
+                inline auto amo(cpu::StaticInst_t &inst, const uint32_t &w, const uint32_t &f3, const uint64_t &addr, const uint64_t &b) -> uint64_t
+                {
+                    if (f3 != 2 && f3 != 3)
+                    {
+                        illegal(w);
+                    }
+                    const bool is_word = (f3 == 2);
+                    const uint32_t f5 = w >> 27;
+                    inst.mem_info = cpu::MemoryInfo_t{addr, uint8_t(f3), f5 != 0x02};
+                    inst.func_info = f5 == 0x02 ? cpu::TYPE_LOAD : cpu::TYPE_STORE;
+                    auto load = [&]() -> uint64_t
+                    {
+                        return is_word ? uint64_t(int64_t(m_memory.load<int32_t>(addr))) : m_memory.load<uint64_t>(addr);
+                    };
+                    auto store = [&](const uint64_t &value)
+                    {
+                        is_word ? m_memory.store<uint32_t>(addr, value) : m_memory.store<uint64_t>(addr, value);
+                    };
+                    if (f5 == 0x02) // lr
+                    {
+                        m_reservation = addr;
+                        m_reservation_valid = true;
+                        return load();
+                    }
+                    if (f5 == 0x03) // sc
+                    {
+                        const bool success = m_reservation_valid && m_reservation == addr;
+                        m_reservation_valid = false;
+                        if (success)
+                        {
+                            store(b);
+                        }
+                        return success ? 0 : 1;
+                    }
+                    const uint64_t old = load();
+                    const uint64_t operand = is_word ? uint64_t(int64_t(int32_t(b))) : b;
+                    uint64_t value;
+                    switch (f5)
+                    {
+                    case 0x00: value = old + operand; break;
+                    case 0x01: value = operand; break;
+                    case 0x04: value = old ^ operand; break;
+                    case 0x08: value = old | operand; break;
+                    case 0x0c: value = old & operand; break;
+                    case 0x10: value = int64_t(old) < int64_t(operand) ? old : operand; break;
+                    case 0x14: value = int64_t(old) > int64_t(operand) ? old : operand; break;
+                    case 0x18: value = (is_word ? uint32_t(old) < uint32_t(operand) : old < operand) ? old : operand; break;
+                    case 0x1c: value = (is_word ? uint32_t(old) > uint32_t(operand) : old > operand) ? old : operand; break;
+                    default: illegal(w); value = old;
+                    }
+                    store(value);
+                    return old;
+                };
+
+                /**
+                 * @brief Proxy the syscall in a7 with arguments in a0-a5
+                 * @return Outcome of the ecall
+                 */
+                auto syscall() -> StepResult_t
+                {
+                    uint64_t *arg = &m_x[10];
+                    int64_t ret;
+                    switch (m_x[17])
+                    {
+                    case 29: // ioctl, no terminal
+                        ret = -ENOTTY;
+                        break;
+                    case 56: // openat
+                        ret = host(::openat(int(arg[0]), m_memory.readString(arg[1]).c_str(), int(arg[2]), mode_t(arg[3])));
+                        break;
+                    case 57: // close, the simulator keeps its standard streams
+                        ret = arg[0] <= 2 ? 0 : host(::close(int(arg[0])));
+                        break;
+                    case 62: // lseek
+                        ret = host(::lseek(int(arg[0]), off_t(arg[1]), int(arg[2])));
+                        break;
+                    case 63: // read
+                    {
+                        std::vector<char> buffer(arg[2]);
+                        ret = host(::read(int(arg[0]), buffer.data(), buffer.size()));
+                        if (ret > 0)
+                        {
+                            m_memory.write(arg[1], buffer.data(), ret);
+                        }
+                        break;
+                    }
+                    case 64: // write
+                    {
+                        std::vector<char> buffer(arg[2]);
+                        m_memory.read(arg[1], buffer.data(), buffer.size());
+                        ret = host(::write(int(arg[0]), buffer.data(), buffer.size()));
+                        break;
+                    }
+                    case 66: // writev
+                    {
+                        std::vector<char> buffer;
+                        for (uint64_t i = 0; i < arg[2]; ++i)
+                        {
+                            const Addr_t base = m_memory.load<uint64_t>(arg[1] + 16 * i);
+                            const uint64_t len = m_memory.load<uint64_t>(arg[1] + 16 * i + 8);
+                            buffer.resize(buffer.size() + len);
+                            m_memory.read(base, buffer.data() + buffer.size() - len, len);
+                        }
+                        ret = host(::write(int(arg[0]), buffer.data(), buffer.size()));
+                        break;
+                    }
+                    case 79: // newfstatat
+                    {
+                        struct stat st;
+                        ret = host(::fstatat(int(arg[0]), m_memory.readString(arg[1]).c_str(), &st, int(arg[3])));
+                        if (ret == 0)
+                        {
+                            writeStat(arg[2], st);
+                        }
+                        break;
+                    }
+                    case 80: // fstat
+                    {
+                        struct stat st;
+                        ret = host(::fstat(int(arg[0]), &st));
+                        if (ret == 0)
+                        {
+                            writeStat(arg[1], st);
+                        }
+                        break;
+                    }
+                    case 93: // exit
+                    case 94: // exit_group
+                        m_exited = true;
+                        m_exit_code = int64_t(arg[0]);
+                        return StepResult_t::EXIT;
+                    case 96:  // set_tid_address
+                    case 172: // getpid
+                    case 178: // gettid
+                        ret = 1;
+                        break;
+                    case 113: // clock_gettime
+                    {
+                        struct timespec ts;
+                        ret = host(::clock_gettime(clockid_t(arg[0]), &ts));
+                        if (ret == 0)
+                        {
+                            m_memory.store<int64_t>(arg[1], ts.tv_sec);
+                            m_memory.store<int64_t>(arg[1] + 8, ts.tv_nsec);
+                        }
+                        break;
+                    }
+                    case 169: // gettimeofday
+                    {
+                        struct timeval tv;
+                        ret = host(::gettimeofday(&tv, nullptr));
+                        if (ret == 0 && arg[0] != 0)
+                        {
+                            m_memory.store<int64_t>(arg[0], tv.tv_sec);
+                            m_memory.store<int64_t>(arg[0] + 8, tv.tv_usec);
+                        }
+                        break;
+                    }
+                    case 160: // uname
+                    {
+                        const char *fields[6] = {"Linux", "archXplore", "5.15.0", "#1", "riscv64", ""};
+                        for (int i = 0; i < 6; ++i)
+                        {
+                            char field[65] = {};
+                            std::strncpy(field, fields[i], sizeof(field) - 1);
+                            m_memory.write(arg[0] + 65 * i, field, sizeof(field));
+                        }
+                        ret = 0;
+                        break;
+                    }
+                    case 174: // getuid
+                    case 175: // geteuid
+                    case 176: // getgid
+                    case 177: // getegid
+                        ret = 0;
+                        break;
+                    case 214: // brk
+                        if (arg[0] >= m_brk_base)
+                        {
+                            m_brk = arg[0];
+                        }
+                        ret = m_brk;
+                        break;
+                    case 222: // mmap
+                        ret = mmap(arg[0], arg[1], int(arg[3]), int(arg[4]), off_t(arg[5]));
+                        break;
+                    case 261: // prlimit64, no limits
+                        if (arg[3] != 0)
+                        {
+                            m_memory.store<uint64_t>(arg[3], ~uint64_t(0));
+                            m_memory.store<uint64_t>(arg[3] + 8, ~uint64_t(0));
+                        }
+                        ret = 0;
+                        break;
+                    case 278: // getrandom
+                        for (uint64_t i = 0; i < arg[1]; ++i)
+                        {
+                            m_memory.store<uint8_t>(arg[0] + i, uint8_t(m_random()));
+                        }
+                        ret = arg[1];
+                        break;
+                    case 99:  // set_robust_list
+                    case 134: // rt_sigaction
+                    case 135: // rt_sigprocmask
+                    case 215: // munmap
+                    case 226: // mprotect
+                    case 233: // madvise
+                        ret = 0;
+                        break;
+                    default:
+                        ret = -ENOSYS;
+                        break;
+                    }
+                    m_x[10] = ret;
+                    return StepResult_t::SYSCALL;
+                };
+
+                /**
+                 * @brief Map guest memory
+                 * @return Guest address, or a negative error
+                 */
+                auto mmap(const Addr_t &addr, const uint64_t &length, const int &flags, const int &fd, const off_t &offset) -> int64_t
+                {
+                    static constexpr int MAP_FIXED_FLAG = 0x10;
+                    static constexpr int MAP_ANONYMOUS_FLAG = 0x20;
+                    Addr_t base;
+                    if ((flags & MAP_FIXED_FLAG) && addr != 0)
+                    {
+                        base = addr;
+                    }
+                    else
+                    {
+                        // Freed ranges are never reused, pages are only allocated when touched
+                        base = m_mmap_top;
+                        m_mmap_top += (length + RiscvMemory::PAGE_MASK) & ~RiscvMemory::PAGE_MASK;
+                    }
+                    if (!(flags & MAP_ANONYMOUS_FLAG))
+                    {
+                        std::vector<char> buffer(length);
+                        const ssize_t n = ::pread(fd, buffer.data(), length, offset);
+                        if (n < 0)
+                        {
+                            return -errno;
+                        }
+                        m_memory.write(base, buffer.data(), n);
+                    }
+                    return base;
+                };
+
+                /**
+                 * @brief Store a host stat in the RISC-V layout
+                 *
+                 * @return void
+                 */
+                auto writeStat(const Addr_t &addr, const struct stat &st) -> void
+                {
+                    uint8_t buffer[128] = {};
+                    auto put = [&buffer](const size_t &offset, const auto &value)
+                    {
+                        std::memcpy(buffer + offset, &value, sizeof(value));
+                    };
+                    put(0, uint64_t(st.st_dev));
+                    put(8, uint64_t(st.st_ino));
+                    put(16, uint32_t(st.st_mode));
+                    put(20, uint32_t(st.st_nlink));
+                    put(24, uint32_t(st.st_uid));
+                    put(28, uint32_t(st.st_gid));
+                    put(32, uint64_t(st.st_rdev));
+                    put(48, int64_t(st.st_size));
+                    put(56, int32_t(st.st_blksize));
+                    put(64, int64_t(st.st_blocks));
+                    put(72, int64_t(st.st_atim.tv_sec));
+                    put(80, uint64_t(st.st_atim.tv_nsec));
+                    put(88, int64_t(st.st_mtim.tv_sec));
+                    put(96, uint64_t(st.st_mtim.tv_nsec));
+                    put(104, int64_t(st.st_ctim.tv_sec));
+                    put(112, uint64_t(st.st_ctim.tv_nsec));
+                    m_memory.write(addr, buffer, sizeof(buffer));
+                };
+
+                /**
+                 * @brief Build the initial stack: argc, argv, envp and the auxiliary vector
+                 * @param argv Command line, starting with the executable
+                 *
+                 * @return void
+                 */
+                auto setupStack(const std::vector<std::string> &argv) -> void
+                {
+                    Addr_t sp = STACK_TOP;
+                    std::vector<Addr_t> argv_addrs;
+                    for (auto &arg : argv)
+                    {
+                        sp -= arg.size() + 1;
+                        m_memory.write(sp, arg.c_str(), arg.size() + 1);
+                        argv_addrs.push_back(sp);
+                    }
+                    sp -= 16;
+                    const Addr_t random_addr = sp;
+                    for (int i = 0; i < 16; ++i)
+                    {
+                        m_memory.store<uint8_t>(random_addr + i, uint8_t(m_random()));
+                    }
+                    // ISA bits of AT_HWCAP
+                    const uint64_t hwcap = (1 << ('I' - 'A')) | (1 << ('M' - 'A')) | (1 << ('A' - 'A')) | (1 << ('C' - 'A'));
+                    const std::vector<std::pair<uint64_t, uint64_t>> auxv = {
+                        {AT_PHDR, m_image.phdr}, {AT_PHENT, m_image.phent}, {AT_PHNUM, m_image.phnum},
+                        {AT_PAGESZ, RiscvMemory::PAGE_SIZE}, {AT_ENTRY, m_image.entry}, {AT_UID, 0}, {AT_EUID, 0},
+                        {AT_GID, 0}, {AT_EGID, 0}, {AT_HWCAP, hwcap}, {AT_CLKTCK, 100}, {AT_SECURE, 0},
+                        {AT_RANDOM, random_addr}, {AT_NULL, 0}};
+                    std::vector<uint64_t> words;
+                    words.push_back(argv.size());
+                    words.insert(words.end(), argv_addrs.begin(), argv_addrs.end());
+                    // No environment
+                    words.push_back(0);
+                    words.push_back(0);
+                    for (auto &entry : auxv)
+                    {
+                        words.push_back(entry.first);
+                        words.push_back(entry.second);
+                    }
+                    sp = (sp - words.size() * sizeof(uint64_t)) & ~Addr_t(15);
+                    m_memory.write(sp, words.data(), words.size() * sizeof(uint64_t));
+                    m_x[2] = sp;
+                };
+
+                static inline auto host(const int64_t &ret) -> int64_t
+                {
+                    return ret < 0 ? -errno : ret;
+                };
+
+                [[noreturn]] auto illegal(const uint32_t &inst) -> void
+                {
+                    std::ostringstream msg;
+                    msg << "Illegal instruction 0x" << std::hex << inst << " at pc 0x" << m_pc;
+                    throw std::runtime_error(msg.str());
+                };
+
+                [[noreturn]] auto fault(const std::string &what) -> void
+                {
+                    std::ostringstream msg;
+                    msg << "Guest " << what << " at pc 0x" << std::hex << m_pc;
+                    throw std::runtime_error(msg.str());
+                };
+
+            private:
+                // Guest memory
+                RiscvMemory m_memory;
+                // Loaded executable
+                ElfImage_t m_image;
+                // Integer registers, x0 is never written
+                uint64_t m_x[32] = {};
+                // Pc of the next instruction
+                Addr_t m_pc = 0;
+                // Executed instructions
+                uint64_t m_inst_count = 0;
+                // Reservation of lr/sc
+                Addr_t m_reservation = 0;
+                bool m_reservation_valid = false;
+                // Program break
+                Addr_t m_brk_base = 0;
+                Addr_t m_brk = 0;
+                // Next address handed out by mmap
+                Addr_t m_mmap_top = MMAP_BASE;
+                // Exit status
+                bool m_exited = false;
+                int64_t m_exit_code = 0;
+                // Source of AT_RANDOM and getrandom bytes
+                std::mt19937_64 m_random{0x5eed};
+            };
+
+        } // namespace riscv
+    } // namespace iss
+} // namespace archXplore
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "Types.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+        namespace riscv
+        {
+
+            /**
+             * @brief Sparse guest memory of an interpreted process
+             *
+             * Pages are allocated zero-filled on first touch. A small direct-mapped
+             * cache of recently used pages keeps instruction fetches and data
+             * accesses off the page table.
+             */
+            class RiscvMemory
+            {
+            public:
+                static constexpr uint64_t PAGE_SHIFT = 12;
+                static constexpr uint64_t PAGE_SIZE = uint64_t(1) << PAGE_SHIFT;
+                static constexpr uint64_t PAGE_MASK = PAGE_SIZE - 1;
+
+                // Entries of the page cache
+                static constexpr size_t PAGE_CACHE_SIZE = 64;
+
+                RiscvMemory() = default;
+
+                RiscvMemory(const RiscvMemory &rhs) = delete;
+                RiscvMemory &operator=(const RiscvMemory &rhs) = delete;
+
+                /**
+                 * @brief Load a value
+                 * @param addr Guest address
+                 * @return The little-endian value at the address
+                 */
+                template <typename T>
+                inline auto load(const Addr_t &addr) -> T
+                {
+                    T value;
+                    if (__glibc_likely((addr & PAGE_MASK) + sizeof(T) <= PAGE_SIZE))
+                    {
+                        std::memcpy(&value, page(addr) + (addr & PAGE_MASK), sizeof(T));
+                    }
+                    else
+                    {
+                        read(addr, &value, sizeof(T));
+                    }
+                    return value;
+                };
+
+                /**
+                 * @brief Store a value
+                 * @param addr Guest address
+                 * @param value The value, stored little-endian
+                 *
+                 * @return void
+                 */
+                template <typename T>
+                inline auto store(const Addr_t &addr, const T &value) -> void
+                {
+                    if (__glibc_likely((addr & PAGE_MASK) + sizeof(T) <= PAGE_SIZE))
+                    {
+                        std::memcpy(page(addr) + (addr & PAGE_MASK), &value, sizeof(T));
+                    }
+                    else
+                    {
+                        write(addr, &value, sizeof(T));
+                    }
+                };
+
+                /**
+                 * @brief Copy guest memory out
+                 * @param addr Guest address
+                 * @param dst Host buffer
+                 * @param size Number of bytes
+                 *
+                 * @return void
+                 */
+                auto read(Addr_t addr, void *dst, size_t size) -> void
+                {
+                    auto out = static_cast<uint8_t *>(dst);
+                    while (size > 0)
+                    {
+                        const size_t n = std::min<size_t>(size, PAGE_SIZE - (addr & PAGE_MASK));
+                        std::memcpy(out, page(addr) + (addr & PAGE_MASK), n);
+                        addr += n;
+                        out += n;
+                        size -= n;
+                    }
+                };
+
+                /**
+                 * @brief Copy into guest memory
+                 * @param addr Guest address
+                 * @param src Host buffer
+                 * @param size Number of bytes
+                 *
+                 * @return void
+                 */
+                auto write(Addr_t addr, const void *src, size_t size) -> void
+                {
+                    auto in = static_cast<const uint8_t *>(src);
+                    while (size > 0)
+                    {
+                        const size_t n = std::min<size_t>(size, PAGE_SIZE - (addr & PAGE_MASK));
+                        std::memcpy(page(addr) + (addr & PAGE_MASK), in, n);
+                        addr += n;
+                        in += n;
+                        size -= n;
+                    }
+                };
+
+                /**
+                 * @brief Read a NUL-terminated string
+                 * @param addr Guest address
+                 * @return The string
+                 */
+                auto readString(Addr_t addr) -> std::string
+                {
+                    std::string str;
+                    for (char c = load<char>(addr); c != '\0'; c = load<char>(++addr))
+                    {
+                        str.push_back(c);
+                    }
+                    return str;
+                };
+
+            private:
+                /**
+                 * @brief Get the host page backing a guest address
+                 * @param addr Guest address
+                 * @return Host address of the page
+                 */
+                inline auto page(const Addr_t &addr) -> uint8_t *
+                {
+                    const uint64_t page_number = addr >> PAGE_SHIFT;
+                    auto &cached = m_page_cache[page_number % PAGE_CACHE_SIZE];
+                    if (__glibc_likely(cached.page_number == page_number))
+                    {
+                        return cached.page;
+                    }
+                    auto &entry = m_pages[page_number];
+                    if (entry == nullptr)
+                    {
+                        entry.reset(new uint8_t[PAGE_SIZE]());
+                    }
+                    cached.page_number = page_number;
+                    cached.page = entry.get();
+                    return cached.page;
+                };
+
+            private:
+                // Allocated pages by page number
+                std::unordered_map<uint64_t, std::unique_ptr<uint8_t[]>> m_pages;
+                // Recently used pages
+                struct CachedPage_t
+                {
+                    uint64_t page_number = ~uint64_t(0);
+                    uint8_t *page = nullptr;
+                };
+                std::array<CachedPage_t, PAGE_CACHE_SIZE> m_page_cache;
+            };
+
+        } // namespace riscv
+    } // namespace iss
+} // namespace archXplore
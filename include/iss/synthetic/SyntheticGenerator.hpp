@@ -0,0 +1,267 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "cpu/StaticInst.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+        namespace synthetic
+        {
+
+            /*
+             * @brief Address pattern of synthetic memory accesses
+             */
+            enum class AddressPattern_t : uint8_t
+            {
+                // Consecutive accesses advance by the stride
+                STRIDED,
+                // Uniformly random accesses within the working set
+                RANDOM,
+                // Accesses within one stack frame around a moving stack pointer
+                STACK
+            };
+
+            /*
+             * @brief Parameters of a synthetic instruction stream
+             */
+            struct SyntheticMix_t
+            {
+                // Instructions per hart
+                uint64_t num_insts = 10000000;
+                // Fraction of branches
+                double branch_rate = 0.15;
+                // Fraction of taken branches
+                double taken_rate = 0.6;
+                // Fraction of loads
+                double load_rate = 0.25;
+                // Fraction of stores
+                double store_rate = 0.1;
+                // Fraction of compressed 2-byte instructions
+                double compressed_rate = 0.25;
+                // Address pattern of loads and stores
+                AddressPattern_t pattern = AddressPattern_t::STRIDED;
+                // Stride of strided accesses in bytes
+                uint64_t stride = 64;
+                // Data working set in bytes
+                uint64_t working_set = 1 << 20;
+                // Code footprint in bytes
+                uint64_t code_footprint = 64 << 10;
+                // Instructions between two syscalls, no syscalls when zero
+                uint64_t syscall_interval = 0;
+                // Random seed, every hart adds its hart index
+                uint64_t seed = 1;
+            };
+
+            /**
+             * @brief Generates a random instruction stream following a mix
+             *
+             * Every decision is a compare of one xorshift draw against a
+             * precomputed threshold, so the generator runs at memory speed.
+             * Control flow is self-consistent: an instruction that does not
+             * redirect is followed by the instruction at pc + len.
+             */
+            class SyntheticGenerator
+            {
+            public:
+                // Base address of the synthetic code
+                static constexpr Addr_t CODE_BASE = 0x10000;
+
+                // Base address of the synthetic data
+                static constexpr Addr_t DATA_BASE = 0x10000000;
+
+                // Top of the synthetic stack
+                static constexpr Addr_t STACK_TOP = 0x7ffff000;
+
+                // Size of a synthetic stack frame in bytes
+                static constexpr uint64_t FRAME_SIZE = 256;
+
+                /**
+                 * @brief Constructor
+                 * @param mix Parameters of the stream
+                 * @param stream_id Index mixed into the seed, e.g. the hart index
+                 */
+                SyntheticGenerator(const SyntheticMix_t &mix, const uint64_t &stream_id = 0)
+                    : m_mix(mix), m_remaining(mix.num_insts)
+                {
+                    m_state = (mix.seed + stream_id) * 0x9e3779b97f4a7c15ull | 1;
+                    m_branch_threshold = threshold(mix.branch_rate);
+                    m_taken_threshold = threshold(mix.taken_rate);
+                    m_load_threshold = threshold(mix.branch_rate + mix.load_rate);
+                    m_store_threshold = threshold(mix.branch_rate + mix.load_rate + mix.store_rate);
+                    m_compressed_threshold = threshold(mix.compressed_rate);
+                    m_code_mask = roundDownPow2(mix.code_footprint) - 1;
+                    m_data_mask = roundDownPow2(mix.working_set) - 1;
+                    m_until_syscall = mix.syscall_interval;
+                    m_pc = CODE_BASE;
+                    m_data_addr = DATA_BASE;
+                    m_stack_pointer = STACK_TOP;
+                };
+
+                /**
+                 * @brief Get the number of instructions left
+                 * @return Remaining instructions
+                 */
+                inline auto remaining() const -> uint64_t
+                {
+                    return m_remaining;
+                };
+
+                /**
+                 * @brief Get the pc of the next instruction
+                 * @return The pc
+                 */
+                inline auto nextPC() const -> Addr_t
+                {
+                    return m_pc;
+                };
+
+                /**
+                 * @brief Generate the next instruction
+                 * @param inst Filled with the instruction
+                 * @return True if a syscall follows the instruction
+                 */
+                inline auto next(cpu::StaticInst_t &inst) -> bool
+                {
+                    inst = cpu::StaticInst_t{};
+                    inst.uid = m_mix.num_insts - m_remaining;
+                    m_remaining--;
+                    inst.pc = m_pc;
+                    inst.len = draw32() < m_compressed_threshold ? 2 : 4;
+                    inst.opcode = uint32_t(m_state) & (inst.len == 2 ? 0xffff : 0xffffffff);
+                    const uint64_t draw = draw64();
+                    inst.src_reg1 = cpu::RegisterInfo_t{cpu::REG_TYPE_GPR, uint8_t(draw & 31)};
+                    inst.src_reg2 = cpu::RegisterInfo_t{cpu::REG_TYPE_GPR, uint8_t((draw >> 5) & 31)};
+                    inst.dst_reg = cpu::RegisterInfo_t{cpu::REG_TYPE_GPR, uint8_t((draw >> 10) & 31)};
+                    Addr_t next_pc = m_pc + inst.len;
+                    const uint32_t kind = uint32_t(draw >> 32);
+                    if (kind < m_branch_threshold)
+                    {
+                        inst.func_info = cpu::TYPE_BRANCH;
+                        if (draw32() < m_taken_threshold)
+                        {
+                            next_pc = CODE_BASE + (draw64() & m_code_mask & ~Addr_t(1));
+                        }
+                    }
+                    else if (kind < m_store_threshold)
+                    {
+                        const bool is_store = kind >= m_load_threshold;
+                        inst.func_info = is_store ? cpu::TYPE_STORE : cpu::TYPE_LOAD;
+                        inst.mem_info = cpu::MemoryInfo_t{dataAddress(), 3, is_store};
+                    }
+                    else
+                    {
+                        inst.func_info = cpu::TYPE_ALU;
+                    }
+                    // Wrap around at the end of the code footprint, a branch stays a
+                    // branch and any other instruction becomes a jump
+                    if (next_pc + 4 > CODE_BASE + m_code_mask + 1)
+                    {
+                        if (inst.func_info != cpu::TYPE_BRANCH)
+                        {
+                            inst.func_info = cpu::TYPE_JUMP;
+                            inst.mem_info = cpu::MemoryInfo_t{};
+                        }
+                        next_pc = CODE_BASE;
+                    }
+                    inst.br_info.target_pc = next_pc;
+                    inst.br_info.redirect = (next_pc != m_pc + inst.len);
+                    m_pc = next_pc;
+                    // Syscalls
+                    if (m_mix.syscall_interval > 0 && --m_until_syscall == 0)
+                    {
+                        m_until_syscall = m_mix.syscall_interval;
+                        return true;
+                    }
+                    return false;
+                };
+
+            private:
+                inline auto dataAddress() -> Addr_t
+                {
+                    switch (m_mix.pattern)
+                    {
+                    case AddressPattern_t::STRIDED:
+                        m_data_addr = DATA_BASE + ((m_data_addr - DATA_BASE + m_mix.stride) & m_data_mask);
+                        return m_data_addr;
+                    case AddressPattern_t::RANDOM:
+                        return DATA_BASE + (draw64() & m_data_mask & ~Addr_t(7));
+                    case AddressPattern_t::STACK:
+                    default:
+                    {
+                        const uint64_t draw = draw64();
+                        // Calls and returns move the frame within the working set
+                        if ((draw & 63) == 0)
+                        {
+                            m_stack_pointer += (draw & 64) ? FRAME_SIZE : -FRAME_SIZE;
+                            m_stack_pointer = STACK_TOP - ((STACK_TOP - m_stack_pointer) & m_data_mask);
+                        }
+                        return m_stack_pointer - FRAME_SIZE + ((draw >> 8) & (FRAME_SIZE - 8));
+                    }
+                    }
+                };
+
+                inline auto draw64() -> uint64_t
+                {
+                    m_state ^= m_state << 13;
+                    m_state ^= m_state >> 7;
+                    m_state ^= m_state << 17;
+                    return m_state;
+                };
+
+                inline auto draw32() -> uint32_t
+                {
+                    return uint32_t(draw64() >> 32);
+                };
+
+                static inline auto threshold(const double &rate) -> uint32_t
+                {
+                    if (rate >= 1.0)
+                    {
+                        return std::numeric_limits<uint32_t>::max();
+                    }
+                    return rate <= 0.0 ? 0 : uint32_t(rate * 4294967296.0);
+                };
+
+                static inline auto roundDownPow2(const uint64_t &value) -> uint64_t
+                {
+                    uint64_t pow2 = 64;
+                    while (pow2 * 2 <= value)
+                    {
+                        pow2 *= 2;
+                    }
+                    return pow2;
+                };
+
+            private:
+                // Parameters of the stream
+                const SyntheticMix_t m_mix;
+                // Instructions left
+                uint64_t m_remaining;
+                // Random state
+                uint64_t m_state;
+                // Draw thresholds of the mix
+                uint32_t m_branch_threshold;
+                uint32_t m_taken_threshold;
+                uint32_t m_load_threshold;
+                uint32_t m_store_threshold;
+                uint32_t m_compressed_threshold;
+                // Address masks of the code and data footprints
+                uint64_t m_code_mask;
+                uint64_t m_data_mask;
+                // Instructions until the next syscall
+                uint64_t m_until_syscall;
+                // Pc of the next instruction
+                Addr_t m_pc;
+                // Last strided address
+                Addr_t m_data_addr;
+                // Current stack pointer
+                Addr_t m_stack_pointer;
+            };
+
+        } // namespace synthetic
+    } // namespace iss
+} // namespace archXplore
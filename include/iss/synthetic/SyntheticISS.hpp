@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <optional>
+
+#include "iss/AbstractISS.hpp"
+#include "iss/synthetic/SyntheticGenerator.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+        namespace synthetic
+        {
+
+            class SyntheticISS : public AbstractISS
+            {
+            public:
+
+                inline auto initCPUState() -> void override;
+
+                inline auto generateFetchRequest(const Addr_t& addr, const size_t& fetch_size) -> void override;
+
+                inline auto processFetchResponse(const uint8_t* data) -> FetchGroup_t override;
+
+                /**
+                 * @brief Constructor
+                 * @param mix Parameters of the generated stream
+                 */
+                SyntheticISS(const SyntheticMix_t& mix);
+
+                ~SyntheticISS();
+
+            protected:
+
+                inline auto handleSyscallApi() -> void;
+
+                inline auto openGenerator() -> SyntheticGenerator&;
+
+                inline auto finish() -> void;
+
+                inline auto wakeUpMonitor() -> void override;
+
+                inline auto initialize() -> void override;
+
+            private:
+
+                // Instructions of the pending fetch
+                FetchPackage m_fetch_package;
+
+                // A fetch request waits for its response
+                bool m_fetch_pending = false;
+
+                // Parameters of the generated stream
+                const SyntheticMix_t m_mix;
+
+                // Generator of this hart
+                std::unique_ptr<SyntheticGenerator> m_generator;
+
+                // Generated instruction that did not fit into the last fetch package
+                std::optional<cpu::StaticInst_t> m_held_inst;
+
+                // A syscall follows the held instruction
+                bool m_held_syscall = false;
+
+            };
+        }
+    } // namespace iss
+} // namespace archXplore
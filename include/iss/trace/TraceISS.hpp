@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <limits>
+
+#include "iss/AbstractISS.hpp"
+#include "iss/TraceReader.hpp"
+
+// Forward Declaration
+namespace archXplore::system::trace
+{
+    class TraceSystem;
+}
+
+namespace archXplore
+{
+    namespace iss
+    {
+        namespace trace
+        {
+
+            class TraceISS : public AbstractISS
+            {
+            public:
+
+                inline auto initCPUState() -> void override;
+
+                inline auto generateFetchRequest(const Addr_t& addr, const size_t& fetch_size) -> void override;
+
+                inline auto processFetchResponse(const uint8_t* data) -> FetchGroup_t override;
+
+                TraceISS();
+
+                ~TraceISS();
+
+            protected:
+
+                inline auto handleSyscallApi(const cpu::ThreadEvent_t& ev) -> void;
+
+                inline auto openStream() -> TraceStream&;
+
+                inline auto exhausted() -> bool;
+
+                inline auto finish() -> void;
+
+                inline auto wakeUpMonitor() -> void override;
+
+                inline auto initialize() -> void override;
+
+            private:
+
+                // Instructions of the pending fetch
+                FetchPackage m_fetch_package;
+
+                // A fetch request waits for its response
+                bool m_fetch_pending = false;
+
+                // Recorded events of this hart
+                std::unique_ptr<TraceStream> m_trace_stream;
+
+                // System owning the mapped trace
+                system::trace::TraceSystem *m_system = nullptr;
+
+                // This hart replays a shard of the trace
+                bool m_is_shard = false;
+
+                // Instructions of the trace before the next one
+                uint64_t m_inst_count = 0;
+
+                // Instruction count at which the replay stops
+                uint64_t m_stop_at = std::numeric_limits<uint64_t>::max();
+
+            };
+        }
+    } // namespace iss
+} // namespace archXplore
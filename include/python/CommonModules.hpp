@@ -2,9 +2,17 @@
 
 #include "iss/AbstractISS.hpp"
 #include "iss/qemu/QemuISS.hpp"
+#include "iss/trace/TraceISS.hpp"
+#include "iss/champsim/ChampSimISS.hpp"
+#include "iss/synthetic/SyntheticISS.hpp"
+#include "iss/riscv/RiscvISS.hpp"
 
 #include "system/AbstractSystem.hpp"
 #include "system/qemu/QemuSystem.hpp"
+#include "system/trace/TraceSystem.hpp"
+#include "system/champsim/ChampSimSystem.hpp"
+#include "system/synthetic/SyntheticSystem.hpp"
+#include "system/riscv/RiscvSystem.hpp"
 #include "system/Process.hpp"
 
 #include "ClockedObject.hpp"
@@ -24,7 +32,42 @@ namespace archXplore
                 .def_readwrite("executable", &archXplore::system::Process::executable, "Process executable path")
                 .def_readwrite("arguments", &archXplore::system::Process::arguments, "Process arguments")
                 .def_readonly("boot_hart", &archXplore::system::Process::boot_hart, "Boot hart ID")
-                .def_readwrite("max_harts", &archXplore::system::Process::max_harts, "Maximum number of harts");
+                .def_readwrite("max_harts", &archXplore::system::Process::max_harts, "Maximum number of harts")
+                .def_readwrite("block_stream", &archXplore::system::Process::block_stream,
+                               "Stream basic block records instead of single instructions")
+                .def_readwrite("fast_forward_insts", &archXplore::system::Process::fast_forward_insts,
+                               "Instructions to fast-forward before detailed simulation starts")
+                .def_readwrite("compress_events", &archXplore::system::Process::compress_events,
+                               "Delta encode the event stream")
+                .def_readwrite("wait_policy", &archXplore::system::Process::wait_policy,
+                               "How both ends of the event stream wait for each other, the policy of the system when None")
+                .def_readwrite("trace_file", &archXplore::system::Process::trace_file,
+                               "Trace file recorded by QEMU, no recording when empty, replayed by TraceSystem; ChampSim trace of ChampSimSystem")
+                .def_readwrite("trace_only", &archXplore::system::Process::trace_only,
+                               "Only record the trace, the process is not simulated")
+                .def_readwrite("shards", &archXplore::system::Process::shards,
+                               "Shards of a replayed single-hart trace, simulated in parallel on consecutive harts")
+                .def_readwrite("warmup_insts", &archXplore::system::Process::warmup_insts,
+                               "Instructions replayed ahead of every shard before its statistics are reset")
+                .def_readwrite("bbv_interval", &archXplore::system::Process::bbv_interval,
+                               "Basic block vector interval, profile only without simulation when non-zero")
+                .def_readwrite("bbv_file", &archXplore::system::Process::bbv_file,
+                               "Basic block vector output file prefix");
+
+            // Bind WaitPolicy
+            pybind11::class_<archXplore::iss::WaitPolicy_t>(parent, "WaitPolicy")
+                .def(pybind11::init<>())
+                .def_readwrite("spin_count", &archXplore::iss::WaitPolicy_t::spin_count, "Polls before the waiter starts yielding")
+                .def_readwrite("yield_count", &archXplore::iss::WaitPolicy_t::yield_count, "Yields before the waiter blocks")
+                .def_readwrite("block", &archXplore::iss::WaitPolicy_t::block, "Block after yielding, otherwise keep yielding")
+                .def_readwrite("block_timeout_us", &archXplore::iss::WaitPolicy_t::block_timeout_us,
+                               "Longest single block in microseconds");
+
+            // Bind InstrumentMode
+            pybind11::enum_<archXplore::iss::InstrumentMode_t>(parent, "InstrumentMode")
+                .value("NONE", archXplore::iss::InstrumentMode_t::NONE, "No instrumentation")
+                .value("COUNT", archXplore::iss::InstrumentMode_t::COUNT, "Count instructions only")
+                .value("FULL", archXplore::iss::InstrumentMode_t::FULL, "Full event stream");
 
             // Bind ClockedObject
             pybind11::class_<ClockedObject, PyClockedObject, sparta::TreeNode>(parent, "ClockedObject")
@@ -51,14 +94,64 @@ namespace archXplore
                 .def("newProcess", &archXplore::system::AbstractSystem::newProcess, py::keep_alive<1, 2>(),
                      pybind11::return_value_policy::reference, "Create a new process")
                 .def("getElapsedTime", &archXplore::system::AbstractSystem::getElapsedTime, "Get the elapsed time of the system")
+                .def("setInstrumentMode", &archXplore::system::AbstractSystem::setInstrumentMode,
+                     pybind11::arg("process"), pybind11::arg("mode"), pybind11::arg("budget") = 0,
+                     "Switch the instrumentation of a running process between NONE, COUNT and FULL, "
+                     "optionally for a budget of instructions")
                 .def_readwrite("max_threads", &archXplore::system::AbstractSystem::m_max_threads, "Maximum number of threads")
                 .def_readwrite("interval", &archXplore::system::AbstractSystem::m_bound_weave_interval,
-                               "Multithreading interval (in ticks)");
+                               "Multithreading interval (in ticks)")
+                .def_readwrite("wait_policy", &archXplore::system::AbstractSystem::m_wait_policy,
+                               "Default wait policy of event streams")
+                .def_readwrite("event_wakeup", &archXplore::system::AbstractSystem::m_event_wakeup,
+                               "Wake up parked CPUs when their ISS notifies them instead of checking every cycle");
 
             // Bind QemuSystem
             pybind11::class_<archXplore::system::qemu::QemuSystem, archXplore::system::AbstractSystem>(system, "QemuSystem", pybind11::dynamic_attr())
                 .def(pybind11::init<>());
 
+            // Bind TraceSystem
+            pybind11::class_<archXplore::system::trace::TraceSystem, archXplore::system::AbstractSystem>(system, "TraceSystem", pybind11::dynamic_attr())
+                .def(pybind11::init<>())
+                .def("getMergedStatistics", &archXplore::system::trace::TraceSystem::getMergedStatistics,
+                     pybind11::arg("process"), "Sum the statistics of all harts of a process after warmup");
+
+            // Bind ChampSimSystem
+            pybind11::class_<archXplore::system::champsim::ChampSimSystem, archXplore::system::AbstractSystem>(system, "ChampSimSystem", pybind11::dynamic_attr())
+                .def(pybind11::init<>());
+
+            // Bind synthetic instruction mix
+            pybind11::enum_<archXplore::iss::synthetic::AddressPattern_t>(system, "AddressPattern")
+                .value("STRIDED", archXplore::iss::synthetic::AddressPattern_t::STRIDED, "Consecutive accesses advance by the stride")
+                .value("RANDOM", archXplore::iss::synthetic::AddressPattern_t::RANDOM, "Uniformly random accesses within the working set")
+                .value("STACK", archXplore::iss::synthetic::AddressPattern_t::STACK, "Accesses around a moving stack pointer");
+            pybind11::class_<archXplore::iss::synthetic::SyntheticMix_t>(system, "SyntheticMix")
+                .def(pybind11::init<>())
+                .def_readwrite("num_insts", &archXplore::iss::synthetic::SyntheticMix_t::num_insts, "Instructions per hart")
+                .def_readwrite("branch_rate", &archXplore::iss::synthetic::SyntheticMix_t::branch_rate, "Fraction of branches")
+                .def_readwrite("taken_rate", &archXplore::iss::synthetic::SyntheticMix_t::taken_rate, "Fraction of taken branches")
+                .def_readwrite("load_rate", &archXplore::iss::synthetic::SyntheticMix_t::load_rate, "Fraction of loads")
+                .def_readwrite("store_rate", &archXplore::iss::synthetic::SyntheticMix_t::store_rate, "Fraction of stores")
+                .def_readwrite("compressed_rate", &archXplore::iss::synthetic::SyntheticMix_t::compressed_rate,
+                               "Fraction of compressed 2-byte instructions")
+                .def_readwrite("pattern", &archXplore::iss::synthetic::SyntheticMix_t::pattern, "Address pattern of loads and stores")
+                .def_readwrite("stride", &archXplore::iss::synthetic::SyntheticMix_t::stride, "Stride of strided accesses in bytes")
+                .def_readwrite("working_set", &archXplore::iss::synthetic::SyntheticMix_t::working_set, "Data working set in bytes")
+                .def_readwrite("code_footprint", &archXplore::iss::synthetic::SyntheticMix_t::code_footprint, "Code footprint in bytes")
+                .def_readwrite("syscall_interval", &archXplore::iss::synthetic::SyntheticMix_t::syscall_interval,
+                               "Instructions between two syscalls, no syscalls when zero")
+                .def_readwrite("seed", &archXplore::iss::synthetic::SyntheticMix_t::seed, "Random seed, every hart adds its hart index");
+
+            // Bind SyntheticSystem
+            pybind11::class_<archXplore::system::synthetic::SyntheticSystem, archXplore::system::AbstractSystem>(system, "SyntheticSystem", pybind11::dynamic_attr())
+                .def(pybind11::init<>())
+                .def_readwrite("mix", &archXplore::system::synthetic::SyntheticSystem::m_mix,
+                               "Instruction mix of all harts, set before building the system");
+
+            // Bind RiscvSystem
+            pybind11::class_<archXplore::system::riscv::RiscvSystem, archXplore::system::AbstractSystem>(system, "RiscvSystem", pybind11::dynamic_attr())
+                .def(pybind11::init<>());
+
 
         };
     } // namespace python
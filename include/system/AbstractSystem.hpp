@@ -1,11 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <unordered_map>
 #include <mutex>
 #include <map>
 #include <future>
 #include <list>
 #include <csignal>
+#include <exception>
+#include <thread>
 
 #include "sparta/simulation/ClockManager.hpp"
 #include "sparta/events/EventSet.hpp"
@@ -14,9 +18,11 @@
 
 #include "ClockedObject.hpp"
 
-#include "utils/ThreadPool.hpp"
+#include "utils/SpinBarrier.hpp"
 #include "cpu/AbstractCPU.hpp"
 #include "iss/AbstractISS.hpp"
+#include "iss/IPCConfig.hpp"
+#include "iss/WaitPolicy.hpp"
 
 #include "system/Process.hpp"
 
@@ -48,6 +54,10 @@ namespace archXplore
             std::unique_ptr<sparta::ClockManager> clock_manager;
             // Tree nodes that belong to this clock domain
             std::map<sparta::Clock::Frequency, ClockDomain_t> domains;
+            // No events are left, the rank is not run until one of its CPUs is woken up
+            bool quiescent = false;
+            // Ticks the rank was not run for while quiescent
+            uint64_t skipped_ticks = 0;
         };
 
         typedef std::map<uint32_t, RankDomain_t> PhaseDomain_t;
@@ -75,6 +85,19 @@ namespace archXplore
              */
             virtual auto cleanUp() -> void{};
 
+            /**
+             * @brief Change the instrumentation mode of a running process
+             * @param process Pointer to the process object
+             * @param mode The requested instrumentation mode
+             * @param budget Instructions to run in the requested mode before returning to the previous one,
+             *               zero keeps it until the next request
+             */
+            virtual auto setInstrumentMode(Process *process, const iss::InstrumentMode_t &mode,
+                                           const uint64_t &budget = 0) -> void
+            {
+                sparta_throw("Instrumentation mode can't be changed in this system!");
+            };
+
             // Delete Copy function
             AbstractSystem(const AbstractSystem &that) = delete;
             AbstractSystem &operator=(const AbstractSystem &that) = delete;
@@ -137,11 +160,38 @@ namespace archXplore
             auto startUpTick(const sparta::Scheduler::Tick &tick) -> void;
 
             /**
-             * @brief Run phase event
-             * @param phase Schedule phase
-             * @return True if the phase is done, false otherwise
+             * @brief Run the ranks of a phase owned by a worker for one interval
+             * @param ranks Ranks of the phase
+             * @param worker Index of the worker
+             */
+            auto runPhaseEvent(const std::vector<RankDomain_t *> &ranks, const size_t &worker) -> void;
+
+            /**
+             * @brief Check whether a phase is done
+             * @param ranks Ranks of the phase
+             * @return True if no rank has events left, false otherwise
+             */
+            auto isPhaseFinished(const std::vector<RankDomain_t *> &ranks) const -> bool;
+
+            /**
+             * @brief Start one worker thread per rank, or per group of ranks
+             * when the number of threads is limited
+             */
+            auto startRankWorkers() -> void;
+
+            /**
+             * @brief Stop and join the rank workers
              */
-            auto runPhaseEvent(PhaseDomain_t& phase) -> bool;
+            auto stopRankWorkers() -> void;
+
+            /**
+             * @brief Main loop of a rank worker
+             * @param worker Index of the worker
+             *
+             * Every interval runs between crossings of the phase barrier: the
+             * bound phase, then the weave phase once all bound ranks are done.
+             */
+            auto runRankWorker(const size_t &worker) -> void;
 
             /**
              * @brief Handle the bound-weave event
@@ -149,6 +199,48 @@ namespace archXplore
             auto handleBoundWeaveEvent() -> void;
 
 
+            /**
+             * @brief Queue a wakeup check of a CPU, safe from any thread
+             * @param cpu Pointer to the CPU object
+             */
+            auto requestWakeUp(cpu::AbstractCPU *cpu) -> void;
+
+            /**
+             * @brief Park a CPU until a wakeup check is requested
+             * @param cpu Pointer to the CPU object
+             */
+            auto parkHart(cpu::AbstractCPU *cpu) -> void;
+
+            /**
+             * @brief Request a wakeup check of every CPU of a process, safe from any thread
+             * @param process Pointer to the process object
+             */
+            auto wakeUpProcess(const Process *process) -> void;
+
+            /**
+             * @brief Schedule the requested wakeup checks
+             *
+             * Runs while no rank scheduler is running, at bound-weave boundaries
+             * or from the wakeup drain event of a single-threaded simulation.
+             */
+            auto drainWakeUps() -> void;
+
+            /**
+             * @brief Block until a wakeup is requested, while nothing else can happen
+             */
+            auto waitForWakeUp() -> void;
+
+            /**
+             * @brief Bring the clock of a quiescent rank to the time of the system
+             * @param rank_domain The rank
+             */
+            auto catchUpRank(RankDomain_t &rank_domain) -> void;
+
+            /**
+             * @brief Handle the wakeup drain event
+             */
+            auto handleWakeUpDrainEvent() -> void;
+
             /**
              * @brief Build the rank domains of the system
              */
@@ -193,6 +285,16 @@ namespace archXplore
                 return m_system_ptr;
             };
 
+            /**
+             * @brief Get the wait policy of the event stream of a process
+             * @param process The process
+             * @return The policy of the process, or the policy of the system
+             */
+            inline auto getWaitPolicy(const Process *process) const -> const iss::WaitPolicy_t &
+            {
+                return process->wait_policy.has_value() ? process->wait_policy.value() : m_wait_policy;
+            };
+
             /**
              * @brief Register a CPU to the system
              * @param cpu Pointer to the CPU object
@@ -214,6 +316,10 @@ namespace archXplore
             uint64_t m_max_threads = 0;
             bool m_bound_weave_enabled = false;
             uint64_t m_bound_weave_interval = 1e6; // 1us
+            // Default wait policy of event streams
+            iss::WaitPolicy_t m_wait_policy;
+            // Parked CPUs are woken up by their ISS instead of checking every cycle
+            bool m_event_wakeup = true;
 
             // Workloads
             std::vector<Process *> m_processes;
@@ -222,8 +328,17 @@ namespace archXplore
             const sparta::Clock::Frequency m_system_freq;
 
         protected:
-            // Thread pool for multi-threading simulation
-            std::unique_ptr<utils::ThreadPool> m_thread_pool;
+            // Rank workers of multi-threading simulation, a worker runs the same ranks every interval
+            std::vector<std::thread> m_rank_workers;
+            // Ranks of each phase in rank order
+            std::vector<RankDomain_t *> m_bound_ranks;
+            std::vector<RankDomain_t *> m_weave_ranks;
+            // Separates the phases of an interval, crossed by the workers and the bound-weave event
+            std::unique_ptr<utils::SpinBarrier> m_phase_barrier;
+            // Workers leave at the next crossing
+            std::atomic<bool> m_workers_stop{false};
+            // Error raised by a worker, rethrown by the bound-weave event
+            std::vector<std::exception_ptr> m_worker_errors;
 
             RankDomain_t m_schedule_phase;
 
@@ -241,6 +356,24 @@ namespace archXplore
             // Bound-Weave event
             sparta::UniqueEvent<sparta::SchedulingPhase::Tick> m_bound_weave_event;
 
+            // Drains wakeup requests every cycle while CPUs are parked, single-threaded only
+            sparta::UniqueEvent<sparta::SchedulingPhase::Update> m_wakeup_drain_event;
+
+            // Wakeup requests from other threads
+            std::mutex m_wakeup_mutex;
+            std::vector<cpu::AbstractCPU *> m_wakeup_requests;
+            std::atomic<bool> m_wakeup_pending{false};
+            std::condition_variable m_wakeup_cv;
+
+            // Waits for a wakeup while every rank is quiescent
+            iss::AdaptiveWaiter m_quiescence_waiter;
+
+            // Rank of every scheduler
+            std::unordered_map<sparta::Scheduler *, RankDomain_t *> m_rank_of_scheduler;
+
+            // CPUs waiting for a wakeup request
+            std::atomic<uint32_t> m_parked_harts{0};
+
             bool m_finalized = false;
 
             //! Default info logger
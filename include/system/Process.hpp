@@ -1,6 +1,9 @@
 #pragma once
 
+#include <optional>
+
 #include "Types.hpp"
+#include "iss/WaitPolicy.hpp"
 
 namespace archXplore
 {
@@ -22,6 +25,27 @@ namespace archXplore
             ProcessID_t boot_hart;
             // Maximum number of hardware threads
             ProcessID_t max_harts = 1;
+            // Stream basic block records instead of single instructions
+            bool block_stream = false;
+            // Instructions to fast-forward before detailed simulation starts, every
+            // hart of a replayed trace seeks past this many of its instructions
+            uint64_t fast_forward_insts = 0;
+            // Delta encode the event stream
+            bool compress_events = false;
+            // How both ends of the event stream wait for each other, the policy of the system when unset
+            std::optional<iss::WaitPolicy_t> wait_policy;
+            // Trace file recorded by QEMU, no recording when empty, replayed by TraceSystem; ChampSim trace of ChampSimSystem
+            std::string trace_file;
+            // Only record the trace, the process is not simulated
+            bool trace_only = false;
+            // Shards of a replayed single-hart trace, simulated in parallel on consecutive harts
+            uint32_t shards = 1;
+            // Instructions replayed ahead of every shard before its statistics are reset
+            uint64_t warmup_insts = 0;
+            // Basic block vector interval, profile only without simulation when non-zero
+            uint64_t bbv_interval = 0;
+            // Basic block vector output file prefix
+            std::string bbv_file = "bbv";
             // Process status
             bool is_completed = false;
         };
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "system/AbstractSystem.hpp"
+#include "iss/champsim/ChampSimISS.hpp"
+
+namespace archXplore
+{
+    namespace system
+    {
+        namespace champsim
+        {
+
+            /**
+             * @brief Simulates ChampSim traces, one single-hart process per trace
+             */
+            class ChampSimSystem : public AbstractSystem
+            {
+            public:
+                /**
+                 * @brief Construct a new ChampSimSystem object
+                 */
+                ChampSimSystem(){};
+                /**
+                 * @brief Destroy the ChampSimSystem object
+                 */
+                ~ChampSimSystem(){};
+
+                /**
+                 * @brief Boot the system.
+                 */
+                auto bootSystem() -> void override
+                {
+                    HartID_t hart_used = 0;
+                    for (auto &process : m_processes)
+                    {
+                        sparta_assert(!process->trace_file.empty(),
+                                      "Process " << process->pid << " has no trace file to replay");
+                        sparta_assert(process->max_harts == 1, "ChampSim traces hold a single hart");
+                        process->boot_hart = hart_used;
+                        hart_used = hart_used + process->max_harts;
+                        sparta_assert(hart_used <= getCPUCount(), "Too many harts requested");
+                        if (SPARTA_EXPECT_FALSE(m_debug_logger))
+                        {
+                            m_debug_logger << "Replaying process " << process->pid
+                                           << " from ChampSim trace " << process->trace_file << std::endl;
+                        }
+                        getCPUPtr(process->boot_hart)->setProcess(process);
+                    }
+                };
+
+                /**
+                 * @brief Create an instance of the ISS.
+                 * @return A unique pointer to the ISS.
+                 */
+                auto createISS() -> std::unique_ptr<iss::AbstractISS> override
+                {
+                    return std::make_unique<iss::champsim::ChampSimISS>();
+                }
+            };
+
+        } // namespace champsim
+    }     // namespace system
+
+} // namespace archXplore
@@ -8,10 +8,13 @@
 #include "sparta/events/StartupEvent.hpp"
 
 #include "iceoryx_posh/internal/roudi/roudi.hpp"
+#include "iceoryx_posh/popo/listener.hpp"
 #include "iceoryx_posh/roudi/iceoryx_roudi_components.hpp"
 
 #include "system/AbstractSystem.hpp"
 #include "iss/qemu/QemuISS.hpp"
+#include "iss/StaticCodeTable.hpp"
+#include "iss/ControlPublisher.hpp"
 
 #include "utils/Subprocess.hpp"
 
@@ -44,10 +47,22 @@ namespace archXplore
                  */
                 auto cleanUp() noexcept(false) -> void override
                 {
+                    // No wakeup is notified once the simulation ends
+                    m_event_listener.reset();
                     // Shutdown QEMU Subprocesses
                     for (auto &process : m_processes)
                     {
-                        if(!process->is_completed)
+                        if(process->is_completed)
+                        {
+                            continue;
+                        }
+                        // Profiling and recording processes run to completion on their own
+                        if(!isSimulated(process))
+                        {
+                            m_qemu_subprocesses.at(process->pid)->wait();
+                            process->is_completed = true;
+                        }
+                        else
                         {
                             m_qemu_subprocesses.at(process->pid)->kill(0);
                         }
@@ -63,7 +78,11 @@ namespace archXplore
                     for (auto &process : m_processes)
                     {
                         process->boot_hart = hart_used;
-                        hart_used = hart_used + process->max_harts;
+                        // Profiling and recording processes are not simulated and take no harts
+                        if (isSimulated(process))
+                        {
+                            hart_used = hart_used + process->max_harts;
+                        }
                         sparta_assert(hart_used <= getCPUCount(), "Too many harts requested");
                         newQemuProcess(process);
                     }
@@ -85,6 +104,15 @@ namespace archXplore
                  */
                 auto newQemuProcess(Process *guest_process) -> void
                 {
+                    // Subscribe to block definitions before QEMU starts translating
+                    if (guest_process->block_stream)
+                    {
+                        m_static_code_tables[guest_process->pid] =
+                            std::make_unique<iss::StaticCodeTable>(getAppName(), guest_process->pid);
+                    }
+                    // Control channel of this process
+                    m_control_publishers[guest_process->pid] =
+                        std::make_unique<iss::ControlPublisher>(getAppName(), guest_process->pid);
                     // Boot QEMU Process
                     std::vector<std::string> command_vec;
                     // QEMU Location
@@ -99,7 +127,25 @@ namespace archXplore
                                              ",Runtime=" + getQemuRuntimeName(guest_process) +
                                              ",ProcessID=" + std::to_string(guest_process->pid) +
                                              ",BootHart=" + std::to_string(guest_process->boot_hart) +
-                                             ",MaxHarts=" + std::to_string(guest_process->max_harts);
+                                             ",MaxHarts=" + std::to_string(guest_process->max_harts) +
+                                             ",BlockStream=" + std::to_string(guest_process->block_stream) +
+                                             ",FastForward=" + std::to_string(guest_process->fast_forward_insts) +
+                                             ",Compress=" + std::to_string(guest_process->compress_events);
+                    const auto &wait_policy = getWaitPolicy(guest_process);
+                    plugin_cmd += ",WaitSpins=" + std::to_string(wait_policy.spin_count) +
+                                  ",WaitYields=" + std::to_string(wait_policy.yield_count) +
+                                  ",WaitBlock=" + std::to_string(wait_policy.block) +
+                                  ",WaitTimeout=" + std::to_string(wait_policy.block_timeout_us);
+                    if (!guest_process->trace_file.empty())
+                    {
+                        plugin_cmd += ",TraceFile=" + guest_process->trace_file +
+                                      ",TraceOnly=" + std::to_string(guest_process->trace_only);
+                    }
+                    if (guest_process->bbv_interval > 0)
+                    {
+                        plugin_cmd += ",BBVInterval=" + std::to_string(guest_process->bbv_interval) +
+                                      ",BBVFile=" + guest_process->bbv_file;
+                    }
                     command_vec.push_back(plugin_cmd);
                     // QEMU guest executable
                     std::string executable_path = guest_process->executable;
@@ -128,6 +174,12 @@ namespace archXplore
                         subprocess::input{subprocess::PIPE},
                         subprocess::output{subprocess::PIPE}));
 
+                    // Profiling and recording processes are not bound to any hart
+                    if (!isSimulated(guest_process))
+                    {
+                        return;
+                    }
+
                     // Boot harts for this process
                     for (HartID_t hart_offset = 0; hart_offset < guest_process->max_harts; hart_offset++)
                     {
@@ -136,6 +188,19 @@ namespace archXplore
                     }
                 };
 
+                /**
+                 * @brief Get the listener notifying harts of arriving events
+                 * @return The listener, created on first use
+                 */
+                auto getEventListener() -> iox::popo::Listener &
+                {
+                    if (m_event_listener == nullptr)
+                    {
+                        m_event_listener = std::make_unique<iox::popo::Listener>();
+                    }
+                    return *m_event_listener;
+                };
+
                 /**
                  * @brief Create an instance of the ISS.
                  * @return A unique pointer to the ISS.
@@ -145,9 +210,53 @@ namespace archXplore
                     return std::make_unique<iss::qemu::QemuISS>();
                 }
 
+                /**
+                 * @brief Change the instrumentation mode of a running QEMU process
+                 * @param process Pointer to the process object
+                 * @param mode The requested instrumentation mode
+                 * @param budget Instructions to run in the requested mode before returning to the previous one,
+                 *               zero keeps it until the next request
+                 */
+                auto setInstrumentMode(Process *process, const iss::InstrumentMode_t &mode,
+                                       const uint64_t &budget = 0) -> void override
+                {
+                    auto it = m_control_publishers.find(process->pid);
+                    sparta_assert(it != m_control_publishers.end(), "Process " << process->pid << " is not running");
+                    it->second->send(mode, budget);
+                }
+
+                /**
+                 * @brief Get the static code table of a process
+                 * @param pid Process ID
+                 * @return Pointer to the table shared by all harts of the process
+                 */
+                auto getStaticCodeTable(const ProcessID_t &pid) const -> const iss::StaticCodeTable *
+                {
+                    auto it = m_static_code_tables.find(pid);
+                    sparta_assert(it != m_static_code_tables.end(), "Process " << pid << " has no static code table");
+                    return it->second.get();
+                }
+
+            private:
+                /**
+                 * @brief Check whether a process is simulated on harts of this system
+                 * @param process The process
+                 * @return False for profiling and trace-only processes
+                 */
+                static auto isSimulated(const Process *process) -> bool
+                {
+                    return process->bbv_interval == 0 && !process->trace_only;
+                }
+
             private:
                 // QEMU Subprocesses
                 std::vector<std::unique_ptr<subprocess::Popen>> m_qemu_subprocesses;
+                // Control channels of QEMU processes
+                std::unordered_map<ProcessID_t, std::unique_ptr<iss::ControlPublisher>> m_control_publishers;
+                // Static code tables of processes streaming block records
+                std::unordered_map<ProcessID_t, std::unique_ptr<iss::StaticCodeTable>> m_static_code_tables;
+                // Notifies harts of arriving events, one thread for all harts
+                std::unique_ptr<iox::popo::Listener> m_event_listener;
             };
 
         } // namespace qemu
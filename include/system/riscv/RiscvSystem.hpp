@@ -0,0 +1,64 @@
+#pragma once
+
+#include "system/AbstractSystem.hpp"
+#include "iss/riscv/RiscvISS.hpp"
+
+namespace archXplore
+{
+    namespace system
+    {
+        namespace riscv
+        {
+
+            /**
+             * @brief Runs statically linked RV64IMAC executables on the built-in interpreter, one single-hart process each
+             */
+            class RiscvSystem : public AbstractSystem
+            {
+            public:
+                /**
+                 * @brief Construct a new RiscvSystem object
+                 */
+                RiscvSystem(){};
+                /**
+                 * @brief Destroy the RiscvSystem object
+                 */
+                ~RiscvSystem(){};
+
+                /**
+                 * @brief Boot the system.
+                 */
+                auto bootSystem() -> void override
+                {
+                    HartID_t hart_used = 0;
+                    for (auto &process : m_processes)
+                    {
+                        sparta_assert(!process->executable.empty(),
+                                      "Process " << process->pid << " has no executable to run");
+                        sparta_assert(process->max_harts == 1, "The RISC-V interpreter runs single-hart processes");
+                        process->boot_hart = hart_used;
+                        hart_used = hart_used + process->max_harts;
+                        sparta_assert(hart_used <= getCPUCount(), "Too many harts requested");
+                        if (SPARTA_EXPECT_FALSE(m_debug_logger))
+                        {
+                            m_debug_logger << "Interpreting process " << process->pid
+                                           << " from " << process->executable << std::endl;
+                        }
+                        getCPUPtr(process->boot_hart)->setProcess(process);
+                    }
+                };
+
+                /**
+                 * @brief Create an instance of the ISS.
+                 * @return A unique pointer to the ISS.
+                 */
+                auto createISS() -> std::unique_ptr<iss::AbstractISS> override
+                {
+                    return std::make_unique<iss::riscv::RiscvISS>();
+                }
+            };
+
+        } // namespace riscv
+    }     // namespace system
+
+} // namespace archXplore
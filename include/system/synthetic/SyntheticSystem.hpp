@@ -0,0 +1,64 @@
+#pragma once
+
+#include "system/AbstractSystem.hpp"
+#include "iss/synthetic/SyntheticISS.hpp"
+
+namespace archXplore
+{
+    namespace system
+    {
+        namespace synthetic
+        {
+
+            /**
+             * @brief Runs generated instruction streams, needs no guest binary or external process
+             */
+            class SyntheticSystem : public AbstractSystem
+            {
+            public:
+                /**
+                 * @brief Construct a new SyntheticSystem object
+                 */
+                SyntheticSystem(){};
+                /**
+                 * @brief Destroy the SyntheticSystem object
+                 */
+                ~SyntheticSystem(){};
+
+                /**
+                 * @brief Boot the system.
+                 */
+                auto bootSystem() -> void override
+                {
+                    HartID_t hart_used = 0;
+                    for (auto &process : m_processes)
+                    {
+                        process->boot_hart = hart_used;
+                        hart_used = hart_used + process->max_harts;
+                        sparta_assert(hart_used <= getCPUCount(), "Too many harts requested");
+                        // Boot harts for this process
+                        for (HartID_t hart_offset = 0; hart_offset < process->max_harts; hart_offset++)
+                        {
+                            getCPUPtr(process->boot_hart + hart_offset)->setProcess(process);
+                        }
+                    }
+                };
+
+                /**
+                 * @brief Create an instance of the ISS.
+                 * @return A unique pointer to the ISS.
+                 */
+                auto createISS() -> std::unique_ptr<iss::AbstractISS> override
+                {
+                    return std::make_unique<iss::synthetic::SyntheticISS>(m_mix);
+                }
+
+            public:
+                // Instruction mix of all harts, read when the system is built
+                iss::synthetic::SyntheticMix_t m_mix;
+            };
+
+        } // namespace synthetic
+    }     // namespace system
+
+} // namespace archXplore
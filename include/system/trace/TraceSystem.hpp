@@ -0,0 +1,202 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <unordered_map>
+
+#include "system/AbstractSystem.hpp"
+#include "iss/trace/TraceISS.hpp"
+#include "iss/TraceReader.hpp"
+
+namespace archXplore
+{
+    namespace system
+    {
+        namespace trace
+        {
+
+            /*
+             * @brief Instruction range of one shard of a trace
+             */
+            struct TraceShard_t
+            {
+                // First replayed instruction
+                uint64_t warmup_begin;
+                // First measured instruction
+                uint64_t begin;
+                // End of the shard, exclusive
+                uint64_t end;
+            };
+
+            class TraceSystem : public AbstractSystem
+            {
+            public:
+                /**
+                 * @brief Construct a new TraceSystem object
+                 */
+                TraceSystem(){};
+                /**
+                 * @brief Destroy the TraceSystem object
+                 */
+                ~TraceSystem(){};
+
+                /**
+                 * @brief Boot the system.
+                 */
+                auto bootSystem() -> void override
+                {
+                    HartID_t hart_used = 0;
+                    for (auto &process : m_processes)
+                    {
+                        process->boot_hart = hart_used;
+                        hart_used = hart_used + getHartCount(process);
+                        sparta_assert(hart_used <= getCPUCount(), "Too many harts requested");
+                        newTraceProcess(process);
+                    }
+                };
+
+                /**
+                 * @brief Map the trace of a process and bind its harts
+                 * @param guest_process Process to be replayed
+                 */
+                auto newTraceProcess(Process *guest_process) -> void
+                {
+                    sparta_assert(!guest_process->trace_file.empty(),
+                                  "Process " << guest_process->pid << " has no trace file to replay");
+                    auto reader = std::make_unique<iss::TraceReader>(guest_process->trace_file);
+                    sparta_assert(guest_process->max_harts <= reader->getNumHarts(),
+                                  "Trace " << guest_process->trace_file << " only holds "
+                                           << reader->getNumHarts() << " harts");
+                    if (guest_process->shards > 1)
+                    {
+                        splitShards(guest_process, *reader);
+                    }
+                    m_trace_readers[guest_process->pid] = std::move(reader);
+
+                    if (SPARTA_EXPECT_FALSE(m_debug_logger))
+                    {
+                        m_debug_logger << "Replaying process " << guest_process->pid
+                                       << " from " << guest_process->trace_file << std::endl;
+                    }
+
+                    // Boot harts for this process
+                    for (HartID_t hart_offset = 0; hart_offset < getHartCount(guest_process); hart_offset++)
+                    {
+                        auto cpu = getCPUPtr(guest_process->boot_hart + hart_offset);
+                        cpu->setProcess(guest_process);
+                    }
+                };
+
+                /**
+                 * @brief Create an instance of the ISS.
+                 * @return A unique pointer to the ISS.
+                 */
+                auto createISS() -> std::unique_ptr<iss::AbstractISS> override
+                {
+                    return std::make_unique<iss::trace::TraceISS>();
+                }
+
+                /**
+                 * @brief Get the mapped trace of a process
+                 * @param pid Process ID
+                 * @return Pointer to the trace shared by all harts of the process
+                 */
+                auto getTraceReader(const ProcessID_t &pid) const -> const iss::TraceReader *
+                {
+                    auto it = m_trace_readers.find(pid);
+                    sparta_assert(it != m_trace_readers.end(), "Process " << pid << " has no trace");
+                    return it->second.get();
+                }
+
+                /**
+                 * @brief Get the shard replayed by a hart
+                 * @param hart_id Hart id
+                 * @return Pointer to the shard, nullptr if the hart replays a whole trace
+                 */
+                auto getShard(const HartID_t &hart_id) const -> const TraceShard_t *
+                {
+                    auto it = m_shards.find(hart_id);
+                    return it == m_shards.end() ? nullptr : &it->second;
+                }
+
+                /**
+                 * @brief Record a finished shard, the process completes with its last shard
+                 * @param process Pointer to the process object
+                 */
+                auto completeShard(Process *process) -> void
+                {
+                    // Shards finish on their own rank threads
+                    if (m_pending_shards.at(process->pid).fetch_sub(1) == 1)
+                    {
+                        process->is_completed = true;
+                    }
+                }
+
+                /**
+                 * @brief Sum the statistics of all harts of a process
+                 * @param process Pointer to the process object
+                 * @return Counter values by name, measured after every shard's warmup
+                 */
+                auto getMergedStatistics(Process *process) -> std::map<std::string, uint64_t>
+                {
+                    std::map<std::string, uint64_t> merged;
+                    for (HartID_t hart_offset = 0; hart_offset < getHartCount(process); hart_offset++)
+                    {
+                        for (auto &stat : getCPUPtr(process->boot_hart + hart_offset)->getStatistics())
+                        {
+                            merged[stat.first] += stat.second;
+                        }
+                    }
+                    return merged;
+                }
+
+            private:
+                /**
+                 * @brief Get the harts used by a process
+                 * @param process The process
+                 * @return One hart per shard of a sharded process, its maximum harts otherwise
+                 */
+                static auto getHartCount(const Process *process) -> HartID_t
+                {
+                    return process->shards > 1 ? process->shards : process->max_harts;
+                }
+
+                /**
+                 * @brief Split the replayed range of a process into equal shards
+                 * @param process Pointer to the process object
+                 * @param reader The mapped trace of the process
+                 *
+                 * Every shard but the first replays up to warmup_insts instructions
+                 * of its predecessor before it starts measuring.
+                 */
+                auto splitShards(Process *process, const iss::TraceReader &reader) -> void
+                {
+                    sparta_assert(process->max_harts == 1, "Only single-hart traces can be sharded");
+                    const uint64_t first = process->fast_forward_insts;
+                    const uint64_t total = reader.getTotalInstCount(0);
+                    sparta_assert(first < total, "Trace " << process->trace_file << " ends before the first shard");
+                    const uint64_t length = total - first;
+                    for (uint32_t shard = 0; shard < process->shards; shard++)
+                    {
+                        TraceShard_t range;
+                        range.begin = first + length * shard / process->shards;
+                        range.end = first + length * (shard + 1) / process->shards;
+                        range.warmup_begin = range.begin - std::min(range.begin - first, process->warmup_insts);
+                        m_shards[process->boot_hart + shard] = range;
+                    }
+                    m_pending_shards[process->pid] = process->shards;
+                }
+
+            private:
+                // Instruction ranges of harts replaying a shard
+                std::unordered_map<HartID_t, TraceShard_t> m_shards;
+                // Unfinished shards of sharded processes
+                std::unordered_map<ProcessID_t, std::atomic<uint32_t>> m_pending_shards;
+                // Mapped traces of processes
+                std::unordered_map<ProcessID_t, std::unique_ptr<iss::TraceReader>> m_trace_readers;
+            };
+
+        } // namespace trace
+    }     // namespace system
+
+} // namespace archXplore
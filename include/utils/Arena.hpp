@@ -0,0 +1,98 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace archXplore
+{
+
+    namespace utils
+    {
+        /**
+         * @brief Append-only object arena
+         *
+         * Objects are constructed in fixed-size blocks and stay at the same address
+         * until the arena is destroyed, so raw pointers can be handed out freely.
+         * Allocation is serialized, reading a constructed object needs no locking.
+         */
+        template <typename T, size_t BlockSize = 4096>
+        class Arena
+        {
+        public:
+            static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destructed");
+
+            Arena() = default;
+
+            Arena(const Arena &that) = delete;
+            Arena &operator=(const Arena &that) = delete;
+
+            /**
+             * @brief Construct a new object inside the arena
+             * @param args Arguments forwarded to the constructor of T
+             * @return Pointer to the constructed object
+             */
+            template <typename... Args>
+            auto create(Args &&...args) -> T *
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_blocks.empty() || m_offset == BlockSize)
+                {
+                    m_blocks.emplace_back(new Storage_t[BlockSize]);
+                    m_offset = 0;
+                }
+                void *slot = &m_blocks.back()[m_offset++];
+                return new (slot) T(std::forward<Args>(args)...);
+            };
+
+            /**
+             * @brief Construct a contiguous array of value-initialized objects
+             * @param count Number of objects, at most BlockSize
+             * @return Pointer to the first object
+             */
+            auto createArray(const size_t &count) -> T *
+            {
+                if (count > BlockSize)
+                {
+                    throw std::length_error("Arena array exceeds block size");
+                }
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_blocks.empty() || m_offset + count > BlockSize)
+                {
+                    m_blocks.emplace_back(new Storage_t[BlockSize]);
+                    m_offset = 0;
+                }
+                T *first = reinterpret_cast<T *>(&m_blocks.back()[m_offset]);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    new (&m_blocks.back()[m_offset++]) T();
+                }
+                return first;
+            };
+
+            /**
+             * @brief Get the number of objects allocated so far
+             * @return Number of objects
+             */
+            auto size() -> size_t
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_blocks.empty() ? 0 : (m_blocks.size() - 1) * BlockSize + m_offset;
+            };
+
+        private:
+            typedef std::aligned_storage_t<sizeof(T), alignof(T)> Storage_t;
+            // Allocation lock
+            std::mutex m_mutex;
+            // Storage blocks
+            std::vector<std::unique_ptr<Storage_t[]>> m_blocks;
+            // Next free slot in the last block
+            size_t m_offset = 0;
+        };
+
+    } // namespace utils
+
+} // namespace archXplore
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/Subprocess.hpp"
+
+namespace archXplore
+{
+
+    namespace utils
+    {
+        /**
+         * @brief Reads a possibly compressed file ahead of its consumer
+         *
+         * Files ending in .xz or .gz are decompressed by an xz or gzip child
+         * process. A background thread fills a bounded queue of blocks from the
+         * file or the decompressor, so decompression overlaps with the consumer.
+         */
+        class PrefetchReader
+        {
+        public:
+            // Bytes per block
+            static constexpr size_t BLOCK_SIZE = 1 << 20;
+
+            // Blocks filled ahead of the consumer
+            static constexpr size_t NUM_BLOCKS = 4;
+
+            PrefetchReader(const PrefetchReader &rhs) = delete;
+            PrefetchReader &operator=(const PrefetchReader &rhs) = delete;
+
+            /**
+             * @brief Constructor
+             * @param path Path of the file
+             */
+            PrefetchReader(const std::string &path)
+            {
+                const auto decompressor = getDecompressor(path);
+                if (decompressor.empty())
+                {
+                    m_file = std::fopen(path.c_str(), "rb");
+                }
+                else
+                {
+                    m_decompressor = std::make_unique<subprocess::Popen>(
+                        std::vector<std::string>{decompressor, "-dc", path},
+                        subprocess::output{subprocess::PIPE});
+                    m_file = m_decompressor->output();
+                }
+                if (m_file == nullptr)
+                {
+                    throw std::runtime_error("Unable to open " + path);
+                }
+                for (size_t i = 0; i < NUM_BLOCKS; ++i)
+                {
+                    m_free_blocks.emplace_back(new Block_t);
+                }
+                m_thread = std::thread(&PrefetchReader::run, this);
+            };
+
+            /**
+             * @brief Destructor
+             */
+            ~PrefetchReader()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stop = true;
+                }
+                m_cond.notify_all();
+                m_thread.join();
+                if (m_decompressor != nullptr)
+                {
+                    // The decompressor may still be writing a file that was not read to the end
+                    m_decompressor->kill();
+                    m_decompressor->wait();
+                }
+                else
+                {
+                    std::fclose(m_file);
+                }
+            };
+
+            /**
+             * @brief Copy the next bytes of the file
+             * @param dst Destination buffer
+             * @param size Number of bytes to copy
+             * @return Number of bytes copied, less than size only at the end of the file
+             */
+            auto read(void *dst, const size_t &size) -> size_t
+            {
+                auto out = static_cast<uint8_t *>(dst);
+                size_t copied = 0;
+                while (copied < size)
+                {
+                    if (m_block == nullptr || m_block_pos == m_block->size)
+                    {
+                        if (!nextBlock())
+                        {
+                            break;
+                        }
+                    }
+                    const size_t n = std::min(size - copied, m_block->size - m_block_pos);
+                    std::memcpy(out + copied, m_block->bytes + m_block_pos, n);
+                    m_block_pos += n;
+                    copied += n;
+                }
+                return copied;
+            };
+
+        private:
+            struct Block_t
+            {
+                // Valid bytes
+                size_t size = 0;
+                uint8_t bytes[BLOCK_SIZE];
+            };
+
+            /**
+             * @brief Pick the decompressor of a file
+             * @param path Path of the file
+             * @return Decompressor command, empty for uncompressed files
+             */
+            static auto getDecompressor(const std::string &path) -> std::string
+            {
+                auto ends_with = [&path](const std::string &suffix)
+                {
+                    return path.size() >= suffix.size() &&
+                           path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+                };
+                if (ends_with(".xz"))
+                {
+                    return "xz";
+                }
+                if (ends_with(".gz"))
+                {
+                    return "gzip";
+                }
+                return "";
+            };
+
+            /**
+             * @brief Hand the consumed block back and wait for the next one
+             * @return False at the end of the file
+             */
+            auto nextBlock() -> bool
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (m_block != nullptr)
+                {
+                    m_free_blocks.emplace_back(std::move(m_block));
+                    m_cond.notify_all();
+                }
+                m_cond.wait(lock, [this]
+                            { return m_eof || !m_full_blocks.empty(); });
+                if (m_full_blocks.empty())
+                {
+                    return false;
+                }
+                m_block = std::move(m_full_blocks.front());
+                m_full_blocks.pop_front();
+                m_block_pos = 0;
+                m_cond.notify_all();
+                return true;
+            };
+
+            /**
+             * @brief Prefetch thread
+             */
+            auto run() -> void
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (true)
+                {
+                    m_cond.wait(lock, [this]
+                                { return m_stop || !m_free_blocks.empty(); });
+                    if (m_stop)
+                    {
+                        break;
+                    }
+                    auto block = std::move(m_free_blocks.back());
+                    m_free_blocks.pop_back();
+                    lock.unlock();
+                    block->size = std::fread(block->bytes, 1, BLOCK_SIZE, m_file);
+                    // fread only comes back short at the end of the file or on an error
+                    const bool done = block->size < BLOCK_SIZE;
+                    lock.lock();
+                    if (block->size > 0)
+                    {
+                        m_full_blocks.emplace_back(std::move(block));
+                    }
+                    m_eof = done;
+                    m_cond.notify_all();
+                    if (done)
+                    {
+                        break;
+                    }
+                }
+            };
+
+        private:
+            // File or decompressor output
+            std::FILE *m_file = nullptr;
+            // Decompressor child process
+            std::unique_ptr<subprocess::Popen> m_decompressor;
+            // Prefetch thread
+            std::thread m_thread;
+            // Queue lock
+            std::mutex m_mutex;
+            // Signals free blocks, full blocks, end of file or stop
+            std::condition_variable m_cond;
+            // Blocks waiting to be filled
+            std::vector<std::unique_ptr<Block_t>> m_free_blocks;
+            // Blocks waiting to be consumed
+            std::deque<std::unique_ptr<Block_t>> m_full_blocks;
+            // Block being consumed
+            std::unique_ptr<Block_t> m_block;
+            // Read position in the current block
+            size_t m_block_pos = 0;
+            // The whole file was read
+            bool m_eof = false;
+            // The reader is being destroyed
+            bool m_stop = false;
+        };
+
+    } // namespace utils
+
+} // namespace archXplore
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace archXplore
+{
+
+    namespace utils
+    {
+        /**
+         * @brief Reusable sense-reversing barrier
+         *
+         * The sense is a generation count, so a thread needs no local state and
+         * can cross any number of barriers. Waiters spin on the generation and
+         * fall back to a condition variable after a bounded number of polls, so
+         * threads waiting for a long time, e.g. while the simulation is paused,
+         * do not keep a core busy. The last thread to arrive only takes the
+         * mutex when somebody went to sleep.
+         */
+        class SpinBarrier
+        {
+        public:
+            // Polls between two yields
+            static constexpr uint32_t YIELD_MASK = 63;
+
+            /**
+             * @brief Constructor
+             * @param parties Number of threads crossing the barrier together
+             * @param spin_count Polls before a waiter blocks
+             */
+            SpinBarrier(const size_t &parties, const uint32_t &spin_count = 1 << 16)
+                : m_parties(parties), m_spin_count(spin_count), m_remaining(parties){};
+
+            SpinBarrier(const SpinBarrier &that) = delete;
+            SpinBarrier &operator=(const SpinBarrier &that) = delete;
+
+            /**
+             * @brief Wait until all parties arrived
+             *
+             * Writes before the barrier are visible to every party after it.
+             */
+            auto arriveAndWait() -> void
+            {
+                const uint64_t generation = m_generation.load(std::memory_order_acquire);
+                if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    // The last party opens the barrier for the next generation
+                    m_remaining.store(m_parties, std::memory_order_relaxed);
+                    m_generation.store(generation + 1, std::memory_order_seq_cst);
+                    if (m_sleepers.load(std::memory_order_seq_cst) > 0)
+                    {
+                        // A sleeper checks the generation under the mutex
+                        {
+                            std::lock_guard<std::mutex> lock(m_mutex);
+                        }
+                        m_cv.notify_all();
+                    }
+                    return;
+                }
+                for (uint32_t i = 0; i < m_spin_count; ++i)
+                {
+                    if (m_generation.load(std::memory_order_acquire) != generation)
+                    {
+                        return;
+                    }
+                    // Let a party sharing the core make progress when threads outnumber cores
+                    if ((i & YIELD_MASK) == YIELD_MASK)
+                    {
+                        std::this_thread::yield();
+                    }
+                    else
+                    {
+                        pause();
+                    }
+                }
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+                m_cv.wait(lock, [&]() { return m_generation.load(std::memory_order_seq_cst) != generation; });
+                m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+            };
+
+            /**
+             * @brief Get the number of parties
+             * @return Number of threads crossing the barrier together
+             */
+            auto getParties() const -> size_t
+            {
+                return m_parties;
+            };
+
+        private:
+            static inline auto pause() -> void
+            {
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#elif defined(__aarch64__)
+                asm volatile("yield");
+#endif
+            };
+
+        private:
+            // Number of threads crossing the barrier together
+            const size_t m_parties;
+            // Polls before a waiter blocks
+            const uint32_t m_spin_count;
+            // Parties that did not arrive yet
+            alignas(64) std::atomic<size_t> m_remaining;
+            // Incremented each time the barrier opens
+            alignas(64) std::atomic<uint64_t> m_generation{0};
+            // Waiters blocked on the condition variable
+            std::atomic<uint32_t> m_sleepers{0};
+            std::mutex m_mutex;
+            std::condition_variable m_cv;
+        };
+
+    } // namespace utils
+
+} // namespace archXplore
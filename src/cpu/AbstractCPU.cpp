@@ -12,6 +12,11 @@ namespace archXplore
               m_trace_logger(tn, "trace", "Instruction trace log"),
               m_cycle(this->getStatisticSet(), "totalCycle", "Number of cycles elapsed", sparta::Counter::CounterBehavior::COUNT_NORMAL),
               m_instret(this->getStatisticSet(), "totalInstRetired", "Number of retired instructions", sparta::Counter::CounterBehavior::COUNT_NORMAL),
+              m_iss_wait_count(this->getStatisticSet(), "issWaitCount", "Number of times the hart waited for events from the ISS", sparta::Counter::CounterBehavior::COUNT_NORMAL),
+              m_iss_spin_time(this->getStatisticSet(), "issSpinTime", "Host time spent spinning for events from the ISS in nanoseconds", sparta::Counter::CounterBehavior::COUNT_NORMAL),
+              m_iss_yield_time(this->getStatisticSet(), "issYieldTime", "Host time spent yielding for events from the ISS in nanoseconds", sparta::Counter::CounterBehavior::COUNT_NORMAL),
+              m_iss_block_time(this->getStatisticSet(), "issBlockTime", "Host time spent blocked on events from the ISS in nanoseconds", sparta::Counter::CounterBehavior::COUNT_NORMAL),
+              m_wakeup_checks(this->getStatisticSet(), "wakeUpChecks", "Number of wakeup monitor checks", sparta::Counter::CounterBehavior::COUNT_NORMAL),
               m_wakeup_monitor_event(this->getEventSet(), "wakeUpMonitor",
                                      CREATE_SPARTA_HANDLER(AbstractCPU, handleWakeUpMonitorEvent), sparta::Clock::Cycle(1)),
               m_tick_event(this->getEventSet(), "tickEvent",
@@ -57,10 +62,28 @@ namespace archXplore
 
         auto AbstractCPU::handleWakeUpMonitorEvent() -> void
         {
-            // 1. Schedule the next wake up monitor event
-            scheduleWakeUpMonitorEvent();
+            m_wakeup_checks++;
+            // 1. Schedule the next wake up monitor event, unless the ISS notifies the cpu
+            const bool notified = m_iss->notifiesWakeUp();
+            if (!notified)
+            {
+                scheduleWakeUpMonitorEvent();
+            }
             // 2. Check if the cpu is ready to wakeup
             m_iss->wakeUpMonitor();
+            // 3. Park until the ISS notifies the cpu
+            if (notified && (m_status == cpuStatus_t::INACTIVE || isBlocked()))
+            {
+                getSystemPtr()->parkHart(this);
+            }
+        };
+
+        auto AbstractCPU::notifyWakeUp() -> void
+        {
+            if (!m_wakeup_requested.exchange(true, std::memory_order_acq_rel))
+            {
+                getSystemPtr()->requestWakeUp(this);
+            }
         };
 
         auto AbstractCPU::scheduleStartupEvent() -> void
@@ -128,7 +151,8 @@ namespace archXplore
         auto AbstractCPU::setProcess(system::Process *process) -> void
         {
             m_process = process;
-            if(process->boot_hart == m_hart_id)
+            // A fast-forwarding process stays parked until its first detailed event arrives
+            if(process->boot_hart == m_hart_id && process->fast_forward_insts == 0)
             {
                  scheduleStartupEvent();
             } else {
@@ -136,6 +160,35 @@ namespace archXplore
             }
         };
 
+        auto AbstractCPU::resetStatistics() -> void
+        {
+            for (auto &counter : getStatisticSet()->getCounters())
+            {
+                m_stat_baseline[counter] = counter->get();
+            }
+        };
+
+        auto AbstractCPU::resetStatisticsAfter(const uint64_t &num_insts) -> void
+        {
+            if (num_insts == 0)
+            {
+                resetStatistics();
+                return;
+            }
+            m_reset_instret = m_instret.get() + num_insts;
+        };
+
+        auto AbstractCPU::getStatistics() -> std::map<std::string, uint64_t>
+        {
+            std::map<std::string, uint64_t> stats;
+            for (auto &counter : getStatisticSet()->getCounters())
+            {
+                auto it = m_stat_baseline.find(counter);
+                stats[counter->getName()] = counter->get() - (it == m_stat_baseline.end() ? 0 : it->second);
+            }
+            return stats;
+        };
+
     } // namespace cpu
 
 } // namespace archXplore
@@ -46,7 +46,7 @@ namespace archXplore
                                        << "pc[" << std::hex << inst->pc << "], "
                                        << "opcode[" << std::hex << inst->opcode << "]" << std::endl;
                     }
-                    m_instret++;
+                    retireInst();
                     m_inst_buffer.pop();
                     // 4. Update Next PC
                     if (inst->br_info.redirect)
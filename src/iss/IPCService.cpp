@@ -32,7 +32,11 @@ int main(int argc, char *argv[])
     iox::mepoo::MePooConfig mepooConfig;
 
     /// @details Format: addMemPool({Chunksize(bytes), Amount of Chunks})
-    mepooConfig.addMemPool({archXplore::iss::MESSAGE_CHUNK_SIZE, archXplore::iss::MAX_HARTS * archXplore::iss::MESSAGE_BUFFER_SIZE * 3}); // bytes
+    /// @details One mempool per event chunk size class, a loan is served by the smallest class that fits
+    for (const auto &chunk_class : archXplore::iss::EVENT_CHUNK_CLASSES)
+    {
+        mepooConfig.addMemPool({archXplore::iss::eventChunkSize(chunk_class.capacity), chunk_class.num_chunks}); // bytes
+    }
 
     /// We want to use the Shared Memory Segment for the current user
     auto currentGroup = iox::PosixGroup::getGroupOfCurrentProcess();
@@ -0,0 +1,124 @@
+#include "iss/champsim/ChampSimISS.hpp"
+#include "cpu/AbstractCPU.hpp"
+#include "system/AbstractSystem.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+        namespace champsim
+        {
+
+            auto ChampSimISS::initCPUState() -> void
+            {
+                // 0. Decode the first instructions of the trace
+                openTrace();
+                sparta_assert(!exhausted(), "Trace " << m_cpu->m_process->trace_file << " is empty");
+                // 1. Initialize boot PC
+                m_cpu->m_boot_pc = m_batch[m_batch_pos].pc;
+                // 2. Set CPU status to active
+                m_cpu->m_status = cpu::cpuStatus_t::ACTIVE;
+            };
+
+            auto ChampSimISS::generateFetchRequest(const Addr_t &addr, const size_t &fetch_size) -> void
+            {
+                Addr_t cur_fetch_pc = addr;
+                m_fetch_package.reset();
+                while (cur_fetch_pc < addr + fetch_size && !exhausted())
+                {
+                    auto& inst = m_batch[m_batch_pos];
+                    if ((cur_fetch_pc != inst.pc) || (cur_fetch_pc + inst.len > addr + fetch_size))
+                    {
+                        break;
+                    }
+                    // Viewed in the batch until a refill detaches the package
+                    m_fetch_package.append(inst);
+                    cur_fetch_pc += inst.len;
+                    m_batch_pos++;
+                    if (SPARTA_EXPECT_FALSE(exhausted()))
+                    {
+                        m_cpu->cancelNextTickEvent();
+                        m_cpu->m_status = cpu::cpuStatus_t::COMPLETED;
+                        m_cpu->m_process->is_completed = true;
+                    }
+                }
+                m_fetch_pending = true;
+            };
+
+            auto ChampSimISS::processFetchResponse(const uint8_t *data) -> FetchGroup_t
+            {
+                sparta_assert(m_fetch_pending, "No fetch request pending");
+                m_fetch_pending = false;
+                return m_fetch_package.group();
+            };
+
+            auto ChampSimISS::openTrace() -> void
+            {
+                if (m_reader != nullptr)
+                {
+                    return;
+                }
+                m_reader = std::make_unique<ChampSimReader>(m_cpu->m_process->trace_file);
+                m_batch.reserve(DECODE_BATCH);
+                // Fast-forwarding decodes and drops the leading instructions
+                uint64_t skip = m_cpu->m_process->fast_forward_insts;
+                while (skip > 0)
+                {
+                    m_batch.clear();
+                    const size_t num_insts = m_reader->read(m_batch, std::min<uint64_t>(skip, DECODE_BATCH));
+                    if (num_insts == 0)
+                    {
+                        break;
+                    }
+                    skip -= num_insts;
+                }
+                m_batch.clear();
+                m_batch_pos = 0;
+            };
+
+            auto ChampSimISS::exhausted() -> bool
+            {
+                if (SPARTA_EXPECT_FALSE(m_batch_pos == m_batch.size()))
+                {
+                    // The pending package may still view the batch
+                    m_fetch_package.detach();
+                    // Decompression runs ahead on the prefetch thread of the reader
+                    m_batch.clear();
+                    m_batch_pos = 0;
+                    m_reader->read(m_batch, DECODE_BATCH);
+                }
+                return m_batch.empty();
+            };
+
+            auto ChampSimISS::wakeUpMonitor() -> void
+            {
+                // A fast-forwarded hart starts once the trace is positioned
+                if (m_cpu->m_status == cpu::cpuStatus_t::INACTIVE)
+                {
+                    openTrace();
+                    m_cpu->cancelWakeUpMonitorEvent();
+                    if (!exhausted())
+                    {
+                        m_cpu->startUp();
+                        m_cpu->m_status = cpu::cpuStatus_t::ACTIVE;
+                        m_cpu->scheduleNextTickEvent();
+                    }
+                    else
+                    {
+                        m_cpu->m_status = cpu::cpuStatus_t::COMPLETED;
+                        m_cpu->m_process->is_completed = true;
+                    }
+                }
+            };
+
+            auto ChampSimISS::initialize() -> void
+            {
+                // The trace is opened once the hart is bound to a process
+            };
+
+            ChampSimISS::ChampSimISS() = default;
+
+            ChampSimISS::~ChampSimISS() = default;
+        }
+    }
+}
@@ -9,6 +9,8 @@ namespace archXplore
         namespace qemu
         {
 
+            // QEMU plugin ID
+            qemu_plugin_id_t InstrumentPlugin::m_plugin_id;
             // Application name
             std::string InstrumentPlugin::m_app_name;
             // Application name
@@ -19,21 +21,82 @@ namespace archXplore
             HartID_t InstrumentPlugin::m_boot_hart;
             // Maximum number of harts
             HartID_t InstrumentPlugin::m_max_harts;
+            // Send basic block records instead of instructions
+            bool InstrumentPlugin::m_block_stream = false;
+            // Instructions to execute before full instrumentation starts
+            uint64_t InstrumentPlugin::m_fast_forward_insts = 0;
+            // Latency bound of buffered events in microseconds, zero disables the bound
+            uint64_t InstrumentPlugin::m_flush_latency = 1000;
+            // Report the flush policy decisions at thread exit
+            bool InstrumentPlugin::m_flush_stats = false;
+            // Delta encode the event stream
+            bool InstrumentPlugin::m_compress_events = false;
+            // How publishers wait for free chunks
+            WaitPolicy_t InstrumentPlugin::m_wait_policy;
+            // Trace file path, recording only when not empty
+            std::string InstrumentPlugin::m_trace_file;
+            // Record the trace without publishing to the simulator
+            bool InstrumentPlugin::m_trace_only = false;
+            // Trace file writer
+            std::unique_ptr<TraceWriter> InstrumentPlugin::m_trace_writer;
+            // Basic block vector interval, profiling only when non-zero
+            uint64_t InstrumentPlugin::m_bbv_interval = 0;
+            // Basic block vector output file prefix
+            std::string InstrumentPlugin::m_bbv_file = "bbv";
+            // Current instrumentation mode
+            std::atomic<InstrumentMode_t> InstrumentPlugin::m_mode(InstrumentMode_t::FULL);
+            // Mode requested by the simulator
+            std::atomic<InstrumentMode_t> InstrumentPlugin::m_requested_mode(InstrumentMode_t::FULL);
+            // Mode before the last switch
+            std::atomic<InstrumentMode_t> InstrumentPlugin::m_previous_mode(InstrumentMode_t::FULL);
+            // Instruction budget of the current mode, zero when unbounded
+            std::atomic<uint64_t> InstrumentPlugin::m_budget(0);
+            // Per-VCPU blocks since the last poll of the simulator requests
+            qemu_plugin_scoreboard *InstrumentPlugin::m_poll_scoreboard = nullptr;
+            qemu_plugin_u64 InstrumentPlugin::m_poll_count;
+            // Per-VCPU instructions run without events since the last switch
+            qemu_plugin_scoreboard *InstrumentPlugin::m_inst_scoreboard = nullptr;
+            qemu_plugin_u64 InstrumentPlugin::m_inst_count;
 
             // Shared Resource Lock
             std::mutex InstrumentPlugin::m_shared_resource_mutex;
-            // Instruction counter for each VCPU
-            std::unordered_map<HartID_t, EventID_t> InstrumentPlugin::m_inst_counters;
-            // Event counter for each VCPU
-            std::unordered_map<HartID_t, EventID_t> InstrumentPlugin::m_event_counters;
-            // Last executed instructions for each VCPU
-            std::unordered_map<HartID_t, cpu::StaticInst_t> InstrumentPlugin::m_last_insts;
-            // Event publisher
-            std::unordered_map<HartID_t, std::unique_ptr<EventPublisher>> InstrumentPlugin::m_event_publishers;
-            // Instruction cache
-            InstrumentPlugin::InstCache_t InstrumentPlugin::m_inst_cache;
-            // Mutex for instruction cache
-            std::shared_mutex InstrumentPlugin::m_inst_cache_mutex;
+            // Fast-forward threshold was reached
+            std::atomic<bool> InstrumentPlugin::m_fast_forward_done(false);
+            // A mode switch is being applied
+            std::atomic<bool> InstrumentPlugin::m_switch_in_progress(false);
+            // Request lock
+            std::mutex InstrumentPlugin::m_request_mutex;
+            // Instruction budget requested with the mode
+            uint64_t InstrumentPlugin::m_requested_budget = 0;
+            // Requests made so far
+            std::atomic<uint64_t> InstrumentPlugin::m_request_generation(0);
+            // Requests seen by the last switch
+            std::atomic<uint64_t> InstrumentPlugin::m_applied_generation(0);
+            // The budget of the current mode ran out
+            std::atomic<bool> InstrumentPlugin::m_budget_done(false);
+            // Basic block vector lock
+            std::mutex InstrumentPlugin::m_bbv_mutex;
+            // Basic block vector entries by block start address
+            std::unordered_map<Addr_t, InstrumentPlugin::BBVEntry_t *> InstrumentPlugin::m_bbv_entries;
+            // Basic block vector entries in ID order
+            std::vector<InstrumentPlugin::BBVEntry_t *> InstrumentPlugin::m_bbv_order;
+            // Basic block vector entry storage
+            utils::Arena<InstrumentPlugin::BBVEntry_t> InstrumentPlugin::m_bbv_arena;
+            // Control requests of the simulator
+            std::unique_ptr<iox::popo::Subscriber<ControlMessage_t>> InstrumentPlugin::m_control_subscriber;
+            std::unique_ptr<iox::popo::Listener> InstrumentPlugin::m_control_listener;
+            // State of each VCPU, indexed by VCPU index
+            std::unique_ptr<InstrumentPlugin::VCPUState_t[]> InstrumentPlugin::m_vcpu_states;
+            // Static code publisher
+            std::unique_ptr<EventPublisher> InstrumentPlugin::m_static_publisher;
+            // Instruction descriptors
+            InstrumentPlugin::InstArena_t InstrumentPlugin::m_inst_arena;
+            // Block descriptors
+            InstrumentPlugin::BlockArena_t InstrumentPlugin::m_block_arena;
+            // Block ID allocator
+            std::atomic<BlockID_t> InstrumentPlugin::m_block_counter(0);
+            // Blocks whose definitions are not flushed yet
+            std::vector<const InstrumentPlugin::BlockDescriptor_t *> InstrumentPlugin::m_unflushed_blocks;
         } // namespace qemu
 
     } // namespace iss
@@ -49,7 +112,12 @@ extern "C"
     {
         std::string usage = "\nUsage: -plugin=<plugin name>,AppName=<app name>,"
                             "ProcessID=<process ID>,BootHart=<boot hart ID>,"
-                            "MaxHarts=< maximum number of harts >\n";
+                            "MaxHarts=< maximum number of harts >[,BlockStream=<0|1>]"
+                            "[,FastForward=<instructions>]"
+                            "[,FlushLatency=<microseconds>][,FlushStats=<0|1>][,Compress=<0|1>]"
+                            "[,WaitSpins=<polls>][,WaitYields=<yields>][,WaitBlock=<0|1>][,WaitTimeout=<microseconds>]"
+                            "[,TraceFile=<path>[,TraceOnly=<0|1>]]"
+                            "[,BBVInterval=<instructions>,BBVFile=<output prefix>]\n";
         std::cerr << usage << std::endl;
         std::exit(1);
     }
@@ -92,6 +160,58 @@ extern "C"
                 {
                     archXplore::iss::qemu::InstrumentPlugin::m_max_harts = std::stoi(value);
                 }
+                else if (key == "BlockStream")
+                {
+                    archXplore::iss::qemu::InstrumentPlugin::m_block_stream = std::stoi(value);
+                }
+                else if (key == "FastForward")
+                {
+                    archXplore::iss::qemu::InstrumentPlugin::m_fast_forward_insts = std::stoull(value);
+                }
+                else if (key == "FlushLatency")
+                {
+                    archXplore::iss::qemu::InstrumentPlugin::m_flush_latency = std::stoull(value);
+                }
+                else if (key == "FlushStats")
+                {
+                    archXplore::iss::qemu::InstrumentPlugin::m_flush_stats = std::stoi(value);
+                }
+                else if (key == "Compress")
+                {
+                    archXplore::iss::qemu::InstrumentPlugin::m_compress_events = std::stoi(value);
+                }
+                else if (key == "WaitSpins")
+                {
+                    archXplore::iss::qemu::InstrumentPlugin::m_wait_policy.spin_count = std::stoul(value);
+                }
+                else if (key == "WaitYields")
+                {
+                    archXplore::iss::qemu::InstrumentPlugin::m_wait_policy.yield_count = std::stoul(value);
+                }
+                else if (key == "WaitBlock")
+                {
+                    archXplore::iss::qemu::InstrumentPlugin::m_wait_policy.block = std::stoi(value);
+                }
+                else if (key == "WaitTimeout")
+                {
+                    archXplore::iss::qemu::InstrumentPlugin::m_wait_policy.block_timeout_us = std::stoul(value);
+                }
+                else if (key == "TraceFile")
+                {
+                    archXplore::iss::qemu::InstrumentPlugin::m_trace_file = value;
+                }
+                else if (key == "TraceOnly")
+                {
+                    archXplore::iss::qemu::InstrumentPlugin::m_trace_only = std::stoi(value);
+                }
+                else if (key == "BBVInterval")
+                {
+                    archXplore::iss::qemu::InstrumentPlugin::m_bbv_interval = std::stoull(value);
+                }
+                else if (key == "BBVFile")
+                {
+                    archXplore::iss::qemu::InstrumentPlugin::m_bbv_file = value;
+                }
                 else
                 {
                     print_usage();
@@ -99,16 +219,52 @@ extern "C"
             }
         }
 
-        // Register the instrumentation plugin
-        qemu_plugin_register_vcpu_tb_trans_cb(id, archXplore::iss::qemu::InstrumentPlugin::translateBasicBlock);
+        // Traces hold instruction events only, block records need the live static code table
+        if ((archXplore::iss::qemu::InstrumentPlugin::m_trace_only &&
+             archXplore::iss::qemu::InstrumentPlugin::m_trace_file.empty()) ||
+            (!archXplore::iss::qemu::InstrumentPlugin::m_trace_file.empty() &&
+             archXplore::iss::qemu::InstrumentPlugin::m_block_stream))
+        {
+            print_usage();
+        }
 
-        qemu_plugin_register_vcpu_syscall_cb(id, archXplore::iss::qemu::InstrumentPlugin::syscall);
+        archXplore::iss::qemu::InstrumentPlugin::m_plugin_id = id;
 
-        qemu_plugin_register_vcpu_init_cb(id, archXplore::iss::qemu::InstrumentPlugin::threadInitialize);
+        // One state slot for each possible VCPU, never resized while VCPUs run
+        archXplore::iss::qemu::InstrumentPlugin::m_vcpu_states.reset(
+            new archXplore::iss::qemu::InstrumentPlugin::VCPUState_t[archXplore::iss::qemu::InstrumentPlugin::m_max_harts]);
 
-        qemu_plugin_register_vcpu_exit_cb(id, archXplore::iss::qemu::InstrumentPlugin::threadExit);
+        // Count instructions only until the fast-forward threshold is reached
+        archXplore::iss::qemu::InstrumentPlugin::m_inst_scoreboard = qemu_plugin_scoreboard_new(sizeof(uint64_t));
+        archXplore::iss::qemu::InstrumentPlugin::m_inst_count =
+            qemu_plugin_scoreboard_u64(archXplore::iss::qemu::InstrumentPlugin::m_inst_scoreboard);
+        if (archXplore::iss::qemu::InstrumentPlugin::m_fast_forward_insts > 0)
+        {
+            archXplore::iss::qemu::InstrumentPlugin::m_mode = archXplore::iss::InstrumentMode_t::COUNT;
+        }
+        // Profiling sends no events at all
+        if (archXplore::iss::qemu::InstrumentPlugin::m_bbv_interval > 0)
+        {
+            archXplore::iss::qemu::InstrumentPlugin::m_mode = archXplore::iss::InstrumentMode_t::NONE;
+        }
+        archXplore::iss::qemu::InstrumentPlugin::m_requested_mode =
+            archXplore::iss::qemu::InstrumentPlugin::m_mode.load();
 
-        qemu_plugin_register_atexit_cb(id, archXplore::iss::qemu::InstrumentPlugin::qemuAtExit, NULL);
+        // The writer thread runs before any VCPU starts recording
+        if (!archXplore::iss::qemu::InstrumentPlugin::m_trace_file.empty())
+        {
+            archXplore::iss::qemu::InstrumentPlugin::m_trace_writer =
+                std::make_unique<archXplore::iss::TraceWriter>(archXplore::iss::qemu::InstrumentPlugin::m_trace_file,
+                                                               archXplore::iss::qemu::InstrumentPlugin::m_max_harts);
+        }
+
+        // Mode requests of the simulator are polled by the VCPUs every few blocks
+        archXplore::iss::qemu::InstrumentPlugin::m_poll_scoreboard = qemu_plugin_scoreboard_new(sizeof(uint64_t));
+        archXplore::iss::qemu::InstrumentPlugin::m_poll_count =
+            qemu_plugin_scoreboard_u64(archXplore::iss::qemu::InstrumentPlugin::m_poll_scoreboard);
+
+        // Register the instrumentation plugin
+        archXplore::iss::qemu::InstrumentPlugin::registerCallbacks(id);
 
         archXplore::iss::qemu::InstrumentPlugin::startPublishService();
 
@@ -1,6 +1,7 @@
 #include "iss/qemu/QemuISS.hpp"
 #include "cpu/AbstractCPU.hpp"
 #include "system/AbstractSystem.hpp"
+#include "system/qemu/QemuSystem.hpp"
 
 namespace archXplore
 {
@@ -11,8 +12,9 @@ namespace archXplore
 
             auto QemuISS::initCPUState() -> void
             {
+                applyWaitPolicy();
                 // 0. Aquire the first event from the event queue
-                auto& first_event = m_event_queue->front();
+                auto& first_event = frontEvent();
                 sparta_assert(first_event.tag == first_event.InsnTag, "First event is not an instruction");
                 // 1. Initialize boot PC
                 m_cpu->m_boot_pc = first_event.instruction.pc;
@@ -25,65 +27,211 @@ namespace archXplore
                 // Exit loop flag
                 bool exit_loop = false;
                 // Prefetch the next instruction package here
+                const Addr_t fetch_end = addr + fetch_size;
                 Addr_t cur_fetch_pc = addr;
-                std::vector<cpu::StaticInst_t> fetch_package;
-                while (cur_fetch_pc < addr + fetch_size)
+                m_fetch_package.reset();
+                while (!exit_loop && cur_fetch_pc < fetch_end)
                 {
-                    bool do_pop = true;
-                    cpu::ThreadEvent_t& ev = m_event_queue->front();
-                    if (SPARTA_EXPECT_FALSE(ev.tag == cpu::ThreadEvent_t::ThreadApiTag))
+                    // Instructions expanded from block records come first
+                    if (SPARTA_EXPECT_FALSE(hasExpandedEvents()))
                     {
-                        handleThreadApi(ev);
-                        exit_loop = true;
+                        if (fetchEvent(m_expanded_events[m_expanded_index], false, cur_fetch_pc, fetch_end, exit_loop))
+                        {
+                            m_expanded_index++;
+                        }
+                        continue;
+                    }
+                    // Walk a batch of ready events
+                    const auto batch = m_event_queue->nextBatch(FETCH_BATCH, m_fetch_package);
+                    const bool in_place = m_event_queue->inPlace();
+                    size_t consumed = 0;
+                    while (consumed < batch.size() && !exit_loop && cur_fetch_pc < fetch_end)
+                    {
+                        const cpu::ThreadEvent_t& ev = batch[consumed];
+                        if (SPARTA_EXPECT_FALSE(ev.tag == cpu::ThreadEvent_t::BlockTag) ||
+                            !fetchEvent(ev, in_place, cur_fetch_pc, fetch_end, exit_loop))
+                        {
+                            break;
+                        }
+                        consumed++;
+                    }
+                    const bool at_block = consumed < batch.size() && batch[consumed].tag == cpu::ThreadEvent_t::BlockTag;
+                    m_event_queue->release(consumed);
+                    if (SPARTA_EXPECT_FALSE(at_block && !exit_loop && cur_fetch_pc < fetch_end))
+                    {
+                        expandBlock();
                     }
-                    else if (SPARTA_EXPECT_FALSE(ev.tag == cpu::ThreadEvent_t::SyscallApiTag))
+                }
+                // Waits at chunk transitions are accounted to the hart
+                if (SPARTA_EXPECT_FALSE(m_event_queue->getWaitStats().waits + m_static_code_waiter.getStats().waits !=
+                                        m_reported_waits.waits))
+                {
+                    reportWaits();
+                }
+                m_fetch_pending = true;
+            };
+
+            auto QemuISS::getWaitStats() const -> WaitStats_t
+            {
+                const WaitStats_t &events = m_event_queue->getWaitStats();
+                const WaitStats_t &static_code = m_static_code_waiter.getStats();
+                return WaitStats_t{events.waits + static_code.waits, events.spin_time + static_code.spin_time,
+                                   events.yield_time + static_code.yield_time,
+                                   events.block_time + static_code.block_time};
+            };
+
+            auto QemuISS::reportWaits() -> void
+            {
+                const WaitStats_t stats = getWaitStats();
+                m_cpu->m_iss_wait_count += stats.waits - m_reported_waits.waits;
+                m_cpu->m_iss_spin_time += stats.spin_time - m_reported_waits.spin_time;
+                m_cpu->m_iss_yield_time += stats.yield_time - m_reported_waits.yield_time;
+                m_cpu->m_iss_block_time += stats.block_time - m_reported_waits.block_time;
+                m_reported_waits = stats;
+            };
+
+            auto QemuISS::fetchEvent(const cpu::ThreadEvent_t &ev, const bool &in_place, Addr_t &cur_fetch_pc,
+                                     const Addr_t &fetch_end, bool &exit_loop) -> bool
+            {
+                if (SPARTA_EXPECT_FALSE(ev.tag == cpu::ThreadEvent_t::ThreadApiTag))
+                {
+                    handleThreadApi(ev);
+                    exit_loop = true;
+                }
+                else if (SPARTA_EXPECT_FALSE(ev.tag == cpu::ThreadEvent_t::SyscallApiTag))
+                {
+                    handleSyscallApi(ev);
+                    exit_loop = true;
+                }
+                else
+                {
+                    auto& inst = ev.instruction;
+                    if ((cur_fetch_pc != inst.pc) || (cur_fetch_pc + inst.len > fetch_end))
                     {
-                        handleSyscallApi(ev);
+                        // The event belongs to the next fetch package
                         exit_loop = true;
+                        return false;
+                    }
+                    // Raw events are viewed in the received chunk, decoded and expanded ones are copied
+                    if (SPARTA_EXPECT_TRUE(in_place))
+                    {
+                        m_fetch_package.append(inst, sizeof(cpu::ThreadEvent_t));
                     }
                     else
                     {
-                        auto& inst = ev.instruction;
-                        if ((cur_fetch_pc == inst.pc) && (cur_fetch_pc + inst.len <= addr + fetch_size)) 
-                        {
-                            fetch_package.emplace_back(inst);
-                            cur_fetch_pc += inst.len;
-                        } else {
-                            exit_loop = true;
-                            do_pop = false;
-                        }
+                        m_fetch_package.copy(inst);
                     }
-                    if(do_pop)
+                    cur_fetch_pc += inst.len;
+                }
+                if(SPARTA_EXPECT_FALSE(ev.is_last))
+                {
+                    m_cpu->cancelNextTickEvent();
+                    exit_loop = true;
+                    if(m_cpu->m_hart_id == m_cpu->m_process->boot_hart)
                     {
-                        if(SPARTA_EXPECT_FALSE(ev.is_last))
-                        {
-                            m_cpu->cancelNextTickEvent();
-                            exit_loop = true;
-                            if(m_cpu->m_hart_id == m_cpu->m_process->boot_hart)
-                            {
-                                m_cpu->m_status = cpu::cpuStatus_t::COMPLETED;
-                                m_cpu->m_process->is_completed = true;
-                            } else {
-                                m_cpu->m_status = cpu::cpuStatus_t::INACTIVE;
-                                m_cpu->scheduleWakeUpMonitorEvent();
-                            }
-                        }
-                        m_event_queue->popFront();
+                        m_cpu->m_status = cpu::cpuStatus_t::COMPLETED;
+                        m_cpu->m_process->is_completed = true;
+                        // Parked harts of the process complete too
+                        m_cpu->getSystemPtr()->wakeUpProcess(m_cpu->m_process);
+                    } else {
+                        m_cpu->m_status = cpu::cpuStatus_t::INACTIVE;
+                        m_cpu->scheduleWakeUpMonitorEvent();
                     }
-                    if(SPARTA_EXPECT_FALSE(exit_loop))
+                }
+                return true;
+            };
+
+            auto QemuISS::processFetchResponse(const uint8_t *data) -> FetchGroup_t
+            {
+                sparta_assert(m_fetch_pending, "No fetch request pending");
+                m_fetch_pending = false;
+                return m_fetch_package.group();
+            };
+
+            auto QemuISS::frontEvent() -> const cpu::ThreadEvent_t &
+            {
+                while (!hasExpandedEvents())
+                {
+                    auto &ev = m_event_queue->nextBatch(1, m_fetch_package)[0];
+                    if (SPARTA_EXPECT_TRUE(ev.tag != cpu::ThreadEvent_t::Tag::BLOCK))
                     {
-                        break;
+                        return ev;
                     }
+                    expandBlock();
                 }
-                m_fetch_buffer.emplace_back(fetch_package);
+                return m_expanded_events[m_expanded_index];
             };
 
-            auto QemuISS::processFetchResponse(const uint8_t *data) -> std::vector<cpu::StaticInst_t>
+            auto QemuISS::expandBlock() -> void
             {
-                sparta_assert(!m_fetch_buffer.empty(), "Fetch buffer is empty");
-                auto inst_group = m_fetch_buffer.front();
-                m_fetch_buffer.pop_front();
-                return inst_group;
+                // 0. Gather the records of this block, the buffers keep their capacity
+                sparta_assert(!hasExpandedEvents(), "Block expanded before the previous one was fetched");
+                m_expanded_events.clear();
+                m_expanded_index = 0;
+                auto &first = m_event_queue->nextBatch(1, m_fetch_package)[0];
+                const BlockID_t block_id = first.block.block_id;
+                auto &accesses = m_block_accesses;
+                accesses.assign(first.block.mem, first.block.mem + first.block.num_mem);
+                bool has_more = first.block.has_more;
+                bool is_last = first.is_last;
+                m_event_queue->release(1);
+                while (has_more)
+                {
+                    auto &ev = m_event_queue->nextBatch(1, m_fetch_package)[0];
+                    sparta_assert(ev.tag == cpu::ThreadEvent_t::Tag::BLOCK && ev.block.block_id == block_id,
+                                  "Broken block record chain");
+                    accesses.insert(accesses.end(), ev.block.mem, ev.block.mem + ev.block.num_mem);
+                    has_more = ev.block.has_more;
+                    is_last = ev.is_last;
+                    m_event_queue->release(1);
+                }
+                if (SPARTA_EXPECT_FALSE(m_static_code == nullptr))
+                {
+                    auto system = dynamic_cast<system::qemu::QemuSystem *>(m_cpu->getSystemPtr());
+                    m_static_code = system->getStaticCodeTable(m_cpu->m_process->pid);
+                }
+                // The definition may still be in flight on the static code channel
+                const auto &insts = m_static_code->wait(block_id, m_static_code_waiter).insts;
+                // 1. The first instruction of this block is the successor of the held one
+                if (m_held_inst.has_value())
+                {
+                    auto &held = m_held_inst.value();
+                    held.br_info.target_pc = insts.front().pc;
+                    held.br_info.redirect = (held.pc + held.len != insts.front().pc);
+                    m_expanded_events.emplace_back(cpu::ThreadEvent_t::InsnTag, held.uid, held);
+                    m_held_inst.reset();
+                }
+                // 2. Expand instructions and attach memory accesses
+                auto access = accesses.begin();
+                for (uint16_t i = 0; i < insts.size(); ++i)
+                {
+                    cpu::StaticInst_t inst = insts[i];
+                    inst.uid = m_expanded_inst_counter++;
+                    while (access != accesses.end() && access->index == i)
+                    {
+                        inst.mem_info.vaddr = access->vaddr;
+                        inst.mem_info.len = access->size_shift;
+                        inst.mem_info.is_store = access->is_store;
+                        ++access;
+                    }
+                    if (i + 1 < insts.size())
+                    {
+                        inst.br_info.target_pc = inst.pc + inst.len;
+                        inst.br_info.redirect = false;
+                        m_expanded_events.emplace_back(cpu::ThreadEvent_t::InsnTag, inst.uid, inst);
+                    }
+                    else
+                    {
+                        m_held_inst = inst;
+                    }
+                }
+                // 3. Nothing follows the last block
+                if (is_last)
+                {
+                    m_expanded_events.emplace_back(cpu::ThreadEvent_t::InsnTag, m_held_inst->uid, m_held_inst.value());
+                    m_expanded_events.back().is_last = true;
+                    m_held_inst.reset();
+                }
             };
 
             auto QemuISS::handleThreadApi(const cpu::ThreadEvent_t& ev) -> void{
@@ -100,13 +248,26 @@ namespace archXplore
                 }
             };
 
+            auto QemuISS::applyWaitPolicy() -> void
+            {
+                // The subscriber exists before the hart is bound to a process
+                if (SPARTA_EXPECT_FALSE(!m_wait_policy_applied))
+                {
+                    const WaitPolicy_t &policy = m_cpu->getSystemPtr()->getWaitPolicy(m_cpu->m_process);
+                    m_event_queue->setWaitPolicy(policy);
+                    m_static_code_waiter.setPolicy(policy);
+                    m_wait_policy_applied = true;
+                }
+            };
+
             auto QemuISS::wakeUpMonitor() -> void
             {
+                applyWaitPolicy();
                 switch (m_cpu->m_status)
                 {
                 case cpu::cpuStatus_t::INACTIVE:
                     // TODO : temporary solution, need to implement pthread_create API
-                    if (m_event_queue->tryTake())
+                    if (m_event_queue->ready())
                     {
                         m_cpu->startUp();
                         m_cpu->m_status = cpu::cpuStatus_t::ACTIVE;
@@ -120,7 +281,7 @@ namespace archXplore
                     }
                     break;
                 case cpu::cpuStatus_t::BLOCKED_SYSCALL:
-                    if (m_event_queue->tryTake())
+                    if (m_event_queue->ready())
                     {
                         m_cpu->m_status = cpu::cpuStatus_t::ACTIVE;
                         m_cpu->cancelWakeUpMonitorEvent();
@@ -131,6 +292,11 @@ namespace archXplore
                 }
             };
 
+            auto QemuISS::notifiesWakeUp() const -> bool
+            {
+                return m_notifies_wakeup;
+            };
+
             auto QemuISS::initialize() -> void
             {
                 const auto &hart_id = m_cpu->getHartID();
@@ -138,6 +304,15 @@ namespace archXplore
                 const auto app_name = m_cpu->getSystemPtr()->getAppName();
 
                 m_event_queue = std::make_unique<EventSubscriber>(app_name, hart_id);
+
+                // Harts that can't be attached keep checking every cycle
+                auto system = dynamic_cast<system::qemu::QemuSystem *>(m_cpu->getSystemPtr());
+                if (system != nullptr && system->m_event_wakeup)
+                {
+                    auto cpu = m_cpu;
+                    m_notifies_wakeup = m_event_queue->attachListener(system->getEventListener(),
+                                                                      [cpu]() { cpu->notifyWakeUp(); });
+                }
             };
 
             QemuISS::QemuISS() = default;
@@ -0,0 +1,149 @@
+#include <iostream>
+
+#include "iss/riscv/RiscvISS.hpp"
+#include "cpu/AbstractCPU.hpp"
+#include "system/AbstractSystem.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+        namespace riscv
+        {
+
+            auto RiscvISS::initCPUState() -> void
+            {
+                // 0. Load the executable of this hart
+                auto& interpreter = openInterpreter();
+                // 1. Initialize boot PC
+                m_cpu->m_boot_pc = interpreter.pc();
+                // 2. Set CPU status to active
+                m_cpu->m_status = cpu::cpuStatus_t::ACTIVE;
+            };
+
+            auto RiscvISS::generateFetchRequest(const Addr_t &addr, const size_t &fetch_size) -> void
+            {
+                auto& interpreter = *m_interpreter;
+                Addr_t cur_fetch_pc = addr;
+                m_fetch_package.reset();
+                // Instructions are executed when fetched, the interpreter is always on the correct path
+                while (cur_fetch_pc < addr + fetch_size)
+                {
+                    if (!m_held_inst.has_value())
+                    {
+                        m_held_inst.emplace();
+                        try
+                        {
+                            m_held_result = interpreter.step(m_held_inst.value());
+                        }
+                        catch (const std::runtime_error& e)
+                        {
+                            // The faulting instruction is not fetched
+                            m_held_inst.reset();
+                            stop(e);
+                            break;
+                        }
+                    }
+                    auto& inst = m_held_inst.value();
+                    if ((cur_fetch_pc != inst.pc) || (cur_fetch_pc + inst.len > addr + fetch_size))
+                    {
+                        break;
+                    }
+                    m_fetch_package.copy(inst);
+                    cur_fetch_pc += inst.len;
+                    m_held_inst.reset();
+                    if (SPARTA_EXPECT_FALSE(m_held_result == StepResult_t::EXIT))
+                    {
+                        finish();
+                        break;
+                    }
+                    // The syscall already ran on the host, only the fetch package ends
+                    if (SPARTA_EXPECT_FALSE(m_held_result == StepResult_t::SYSCALL))
+                    {
+                        break;
+                    }
+                }
+                m_fetch_pending = true;
+            };
+
+            auto RiscvISS::processFetchResponse(const uint8_t *data) -> FetchGroup_t
+            {
+                sparta_assert(m_fetch_pending, "No fetch request pending");
+                m_fetch_pending = false;
+                return m_fetch_package.group();
+            };
+
+            auto RiscvISS::openInterpreter() -> RiscvInterpreter&
+            {
+                if (SPARTA_EXPECT_FALSE(m_interpreter == nullptr))
+                {
+                    auto process = m_cpu->m_process;
+                    std::vector<std::string> arguments(process->arguments.begin(), process->arguments.end());
+                    try
+                    {
+                        m_interpreter = std::make_unique<RiscvInterpreter>(process->executable, arguments);
+                    }
+                    catch (const std::runtime_error& e)
+                    {
+                        sparta_throw("Unable to start process " << process->pid << ": " << e.what());
+                    }
+                }
+                return *m_interpreter;
+            };
+
+            auto RiscvISS::finish() -> void
+            {
+                m_cpu->cancelNextTickEvent();
+                m_cpu->m_status = cpu::cpuStatus_t::COMPLETED;
+                m_cpu->m_process->is_completed = true;
+            };
+
+            auto RiscvISS::stop(const std::runtime_error& e) -> void
+            {
+                std::cerr << "Hart " << m_cpu->m_hart_id << " stopped process " << m_cpu->m_process->pid
+                          << ": " << e.what() << std::endl;
+                finish();
+            };
+
+            auto RiscvISS::wakeUpMonitor() -> void
+            {
+                // Syscalls complete in place, only a fast-forwarding boot hart waits to start
+                if (m_cpu->m_status != cpu::cpuStatus_t::INACTIVE)
+                {
+                    return;
+                }
+                m_cpu->cancelWakeUpMonitorEvent();
+                auto& interpreter = openInterpreter();
+                cpu::StaticInst_t inst;
+                try
+                {
+                    for (uint64_t i = 0; i < m_cpu->m_process->fast_forward_insts && !interpreter.exited(); ++i)
+                    {
+                        interpreter.step(inst);
+                    }
+                }
+                catch (const std::runtime_error& e)
+                {
+                    stop(e);
+                    return;
+                }
+                if (interpreter.exited())
+                {
+                    // Nothing is left to simulate after fast-forwarding
+                    finish();
+                    return;
+                }
+                m_cpu->startUp();
+            };
+
+            auto RiscvISS::initialize() -> void
+            {
+                // The interpreter is created once the hart is bound to a process
+            };
+
+            RiscvISS::RiscvISS(){};
+
+            RiscvISS::~RiscvISS() = default;
+        }
+    }
+}
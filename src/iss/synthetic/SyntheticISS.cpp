@@ -0,0 +1,133 @@
+#include "iss/synthetic/SyntheticISS.hpp"
+#include "cpu/AbstractCPU.hpp"
+#include "system/AbstractSystem.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+        namespace synthetic
+        {
+
+            auto SyntheticISS::initCPUState() -> void
+            {
+                // 0. Create the generator of this hart
+                auto& generator = openGenerator();
+                sparta_assert(generator.remaining() > 0 || m_held_inst.has_value(), "Synthetic stream is empty");
+                // 1. Initialize boot PC
+                m_cpu->m_boot_pc = m_held_inst.has_value() ? m_held_inst->pc : generator.nextPC();
+                // 2. Set CPU status to active
+                m_cpu->m_status = cpu::cpuStatus_t::ACTIVE;
+            };
+
+            auto SyntheticISS::generateFetchRequest(const Addr_t &addr, const size_t &fetch_size) -> void
+            {
+                auto& generator = *m_generator;
+                Addr_t cur_fetch_pc = addr;
+                m_fetch_package.reset();
+                while (cur_fetch_pc < addr + fetch_size)
+                {
+                    if (!m_held_inst.has_value())
+                    {
+                        if (SPARTA_EXPECT_FALSE(generator.remaining() == 0))
+                        {
+                            finish();
+                            break;
+                        }
+                        m_held_inst.emplace();
+                        m_held_syscall = generator.next(m_held_inst.value());
+                    }
+                    auto& inst = m_held_inst.value();
+                    if ((cur_fetch_pc != inst.pc) || (cur_fetch_pc + inst.len > addr + fetch_size))
+                    {
+                        break;
+                    }
+                    m_fetch_package.copy(inst);
+                    cur_fetch_pc += inst.len;
+                    m_held_inst.reset();
+                    if (SPARTA_EXPECT_FALSE(m_held_syscall))
+                    {
+                        handleSyscallApi();
+                        break;
+                    }
+                    if (SPARTA_EXPECT_FALSE(generator.remaining() == 0))
+                    {
+                        finish();
+                        break;
+                    }
+                }
+                m_fetch_pending = true;
+            };
+
+            auto SyntheticISS::processFetchResponse(const uint8_t *data) -> FetchGroup_t
+            {
+                sparta_assert(m_fetch_pending, "No fetch request pending");
+                m_fetch_pending = false;
+                return m_fetch_package.group();
+            };
+
+            auto SyntheticISS::handleSyscallApi() -> void
+            {
+                // Block until the next wakeup monitor check, as a hart waiting on QEMU would
+                m_held_syscall = false;
+                if (m_cpu->m_status == cpu::cpuStatus_t::ACTIVE)
+                {
+                    m_cpu->m_status = cpu::cpuStatus_t::BLOCKED_SYSCALL;
+                    m_cpu->cancelNextTickEvent();
+                    m_cpu->scheduleWakeUpMonitorEvent();
+                }
+            };
+
+            auto SyntheticISS::openGenerator() -> SyntheticGenerator&
+            {
+                if (SPARTA_EXPECT_FALSE(m_generator == nullptr))
+                {
+                    // Every hart draws its own stream
+                    m_generator = std::make_unique<SyntheticGenerator>(m_mix, m_cpu->m_hart_id);
+                }
+                return *m_generator;
+            };
+
+            auto SyntheticISS::finish() -> void
+            {
+                m_cpu->cancelNextTickEvent();
+                m_cpu->m_status = cpu::cpuStatus_t::COMPLETED;
+                if (m_cpu->m_hart_id == m_cpu->m_process->boot_hart)
+                {
+                    m_cpu->m_process->is_completed = true;
+                }
+            };
+
+            auto SyntheticISS::wakeUpMonitor() -> void
+            {
+                switch (m_cpu->m_status)
+                {
+                case cpu::cpuStatus_t::INACTIVE:
+                    // Secondary harts start right away
+                    openGenerator();
+                    m_cpu->startUp();
+                    m_cpu->m_status = cpu::cpuStatus_t::ACTIVE;
+                    m_cpu->cancelWakeUpMonitorEvent();
+                    m_cpu->scheduleNextTickEvent();
+                    break;
+                case cpu::cpuStatus_t::BLOCKED_SYSCALL:
+                    m_cpu->m_status = cpu::cpuStatus_t::ACTIVE;
+                    m_cpu->cancelWakeUpMonitorEvent();
+                    m_cpu->scheduleNextTickEvent();
+                    break;
+                default:
+                    break;
+                }
+            };
+
+            auto SyntheticISS::initialize() -> void
+            {
+                // The generator is created once the hart is bound to a process
+            };
+
+            SyntheticISS::SyntheticISS(const SyntheticMix_t& mix) : m_mix(mix){};
+
+            SyntheticISS::~SyntheticISS() = default;
+        }
+    }
+}
@@ -0,0 +1,190 @@
+#include "iss/trace/TraceISS.hpp"
+#include "cpu/AbstractCPU.hpp"
+#include "system/AbstractSystem.hpp"
+#include "system/trace/TraceSystem.hpp"
+
+namespace archXplore
+{
+    namespace iss
+    {
+        namespace trace
+        {
+
+            auto TraceISS::initCPUState() -> void
+            {
+                // 0. Aquire the first event from the trace
+                auto& stream = openStream();
+                sparta_assert(!exhausted(), "Trace of hart " << m_cpu->m_hart_id << " is empty");
+                auto& first_event = stream.front();
+                sparta_assert(first_event.tag == first_event.InsnTag, "First event is not an instruction");
+                // 1. Initialize boot PC
+                m_cpu->m_boot_pc = first_event.instruction.pc;
+                // 2. Set CPU status to active
+                m_cpu->m_status = cpu::cpuStatus_t::ACTIVE;
+            };
+
+            auto TraceISS::generateFetchRequest(const Addr_t &addr, const size_t &fetch_size) -> void
+            {
+                auto& stream = *m_trace_stream;
+                // Exit loop flag
+                bool exit_loop = false;
+                // Decode the next instruction package straight from the mapped trace
+                Addr_t cur_fetch_pc = addr;
+                m_fetch_package.reset();
+                while (cur_fetch_pc < addr + fetch_size && !exhausted())
+                {
+                    bool do_pop = true;
+                    const cpu::ThreadEvent_t& ev = stream.front();
+                    if (SPARTA_EXPECT_FALSE(ev.tag == cpu::ThreadEvent_t::SyscallApiTag))
+                    {
+                        handleSyscallApi(ev);
+                        exit_loop = true;
+                    }
+                    else if (SPARTA_EXPECT_FALSE(ev.tag != cpu::ThreadEvent_t::InsnTag))
+                    {
+                        // Thread events carry no work in a replay
+                        exit_loop = true;
+                    }
+                    else
+                    {
+                        auto& inst = ev.instruction;
+                        if ((cur_fetch_pc == inst.pc) && (cur_fetch_pc + inst.len <= addr + fetch_size))
+                        {
+                            // The decoder reuses its event, the instruction is copied
+                            m_fetch_package.copy(inst);
+                            cur_fetch_pc += inst.len;
+                            ++m_inst_count;
+                        } else {
+                            exit_loop = true;
+                            do_pop = false;
+                        }
+                    }
+                    if(do_pop)
+                    {
+                        const bool is_last = ev.is_last;
+                        stream.popFront();
+                        // A trace cut short by a killed recording ends without a last event
+                        if(SPARTA_EXPECT_FALSE(is_last || exhausted()))
+                        {
+                            finish();
+                            exit_loop = true;
+                        }
+                    }
+                    if(SPARTA_EXPECT_FALSE(exit_loop))
+                    {
+                        break;
+                    }
+                }
+                m_fetch_pending = true;
+            };
+
+            auto TraceISS::processFetchResponse(const uint8_t *data) -> FetchGroup_t
+            {
+                sparta_assert(m_fetch_pending, "No fetch request pending");
+                m_fetch_pending = false;
+                return m_fetch_package.group();
+            };
+
+            auto TraceISS::handleSyscallApi(const cpu::ThreadEvent_t& ev) -> void
+            {
+                // The syscall already completed while recording and its results are
+                // in the trace, so the hart only ends the fetch package here
+            };
+
+            auto TraceISS::openStream() -> TraceStream&
+            {
+                if (SPARTA_EXPECT_FALSE(m_trace_stream == nullptr))
+                {
+                    m_system = dynamic_cast<system::trace::TraceSystem *>(m_cpu->getSystemPtr());
+                    sparta_assert(m_system != nullptr, "TraceISS requires a TraceSystem");
+                    const auto& process = m_cpu->m_process;
+                    const auto shard = m_system->getShard(m_cpu->m_hart_id);
+                    m_is_shard = (shard != nullptr);
+                    // All shards replay the single hart of the trace
+                    m_trace_stream = std::make_unique<TraceStream>(*m_system->getTraceReader(process->pid),
+                                                                   m_is_shard ? 0 : m_cpu->m_hart_id - process->boot_hart);
+                    // Fast-forwarding a recorded process is a seek in its trace
+                    m_inst_count = m_is_shard ? shard->warmup_begin : process->fast_forward_insts;
+                    if (m_inst_count > 0)
+                    {
+                        m_trace_stream->seek(m_inst_count);
+                    }
+                    if (m_is_shard)
+                    {
+                        // The warmup of a shard ends when its last instruction retires
+                        m_cpu->resetStatisticsAfter(shard->begin - shard->warmup_begin);
+                        m_stop_at = shard->end;
+                    }
+                }
+                return *m_trace_stream;
+            };
+
+            auto TraceISS::exhausted() -> bool
+            {
+                return m_trace_stream->empty() || m_inst_count >= m_stop_at;
+            };
+
+            auto TraceISS::finish() -> void
+            {
+                m_cpu->cancelNextTickEvent();
+                if (m_is_shard)
+                {
+                    m_cpu->m_status = cpu::cpuStatus_t::COMPLETED;
+                    m_cpu->cancelWakeUpMonitorEvent();
+                    m_system->completeShard(m_cpu->m_process);
+                }
+                else if (m_cpu->m_hart_id == m_cpu->m_process->boot_hart)
+                {
+                    m_cpu->m_status = cpu::cpuStatus_t::COMPLETED;
+                    m_cpu->cancelWakeUpMonitorEvent();
+                    m_cpu->m_process->is_completed = true;
+                }
+                else
+                {
+                    m_cpu->m_status = cpu::cpuStatus_t::INACTIVE;
+                    m_cpu->scheduleWakeUpMonitorEvent();
+                }
+            };
+
+            auto TraceISS::wakeUpMonitor() -> void
+            {
+                switch (m_cpu->m_status)
+                {
+                case cpu::cpuStatus_t::INACTIVE:
+                    // Secondary harts and shards start as soon as their trace has
+                    // events, a finished hart stays parked until the process completes
+                    openStream();
+                    if (!exhausted())
+                    {
+                        m_cpu->startUp();
+                        m_cpu->m_status = cpu::cpuStatus_t::ACTIVE;
+                        m_cpu->cancelWakeUpMonitorEvent();
+                        m_cpu->scheduleNextTickEvent();
+                    }
+                    else if (m_is_shard || m_cpu->m_hart_id == m_cpu->m_process->boot_hart)
+                    {
+                        // Nothing is left to replay after fast-forwarding
+                        finish();
+                    }
+                    else if (m_cpu->m_process->is_completed)
+                    {
+                        m_cpu->m_status = cpu::cpuStatus_t::COMPLETED;
+                        m_cpu->cancelWakeUpMonitorEvent();
+                    }
+                    break;
+                default:
+                    break;
+                }
+            };
+
+            auto TraceISS::initialize() -> void
+            {
+                // The trace is opened once the hart is bound to a process
+            };
+
+            TraceISS::TraceISS() = default;
+
+            TraceISS::~TraceISS() = default;
+        }
+    }
+}
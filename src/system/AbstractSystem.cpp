@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <utility>
+
 #include "system/AbstractSystem.hpp"
 
 namespace archXplore
@@ -14,7 +17,9 @@ namespace archXplore
               m_warn_logger(this, WARN_LOG, getName() + " Warning Messages"),
               m_system_freq(freq), m_bound_weave_interval(1000 * freq),
               m_bound_weave_event(&m_global_event_set, "BoundWeaveEvent",
-                                  CREATE_SPARTA_HANDLER(AbstractSystem, handleBoundWeaveEvent))
+                                  CREATE_SPARTA_HANDLER(AbstractSystem, handleBoundWeaveEvent)),
+              m_wakeup_drain_event(&m_global_event_set, "WakeUpDrainEvent",
+                                   CREATE_SPARTA_HANDLER(AbstractSystem, handleWakeUpDrainEvent), sparta::Clock::Cycle(1))
         {
             // Add AbstractSystem as a child of the root node
             m_root_node.addChild(this);
@@ -24,7 +29,10 @@ namespace archXplore
             this->setClockDomain(SCHEDULE_PHASE, 0, freq);
         };
 
-        AbstractSystem::~AbstractSystem(){};
+        AbstractSystem::~AbstractSystem()
+        {
+            stopRankWorkers();
+        };
 
         auto AbstractSystem::getCPUCount() -> uint32_t
         {
@@ -93,15 +101,8 @@ namespace archXplore
                 auto &rank_domain = it.second;
                 rank_domain.scheduler->finalize();
             }
-            // Construct thread pool when multi-threading is enabled
-            if (m_max_threads == 0)
-            {
-                m_max_threads = std::max(m_bound_phase.size(), m_weave_phase.size());
-            }
-            if (m_max_threads > 0)
-            {
-                m_thread_pool = std::make_unique<utils::ThreadPool>(m_max_threads);
-            }
+            // Start rank workers when multi-threading is enabled
+            startRankWorkers();
             // Bind tree late
             m_root_node.bindTreeLate();
             // Enter teardown state
@@ -110,53 +111,251 @@ namespace archXplore
             bootSystem();
         };
 
-        auto AbstractSystem::runPhaseEvent(PhaseDomain_t &phase) -> bool
+        auto AbstractSystem::startRankWorkers() -> void
         {
-            bool finished = true;
-            std::vector<std::future<bool>> futures;
-            // Run bound phase schedulers in parallel
-            if (SPARTA_EXPECT_TRUE(!phase.empty()))
+            for (auto &it : m_bound_phase)
+            {
+                m_bound_ranks.push_back(&it.second);
+            }
+            for (auto &it : m_weave_phase)
+            {
+                m_weave_ranks.push_back(&it.second);
+            }
+            const size_t num_ranks = std::max(m_bound_ranks.size(), m_weave_ranks.size());
+            if (m_max_threads == 0 || m_max_threads > num_ranks)
             {
-                for (auto &it : phase)
+                m_max_threads = num_ranks;
+            }
+            if (m_max_threads == 0)
+            {
+                return;
+            }
+            // The bound-weave event crosses the barrier with the workers
+            m_phase_barrier = std::make_unique<utils::SpinBarrier>(m_max_threads + 1, m_wait_policy.spin_count);
+            m_worker_errors.resize(m_max_threads);
+            for (size_t worker = 0; worker < m_max_threads; ++worker)
+            {
+                m_rank_workers.emplace_back([this, worker]() { runRankWorker(worker); });
+            }
+        };
+
+        auto AbstractSystem::stopRankWorkers() -> void
+        {
+            if (m_rank_workers.empty())
+            {
+                return;
+            }
+            m_workers_stop.store(true, std::memory_order_relaxed);
+            m_phase_barrier->arriveAndWait();
+            for (auto &worker : m_rank_workers)
+            {
+                worker.join();
+            }
+            m_rank_workers.clear();
+        };
+
+        auto AbstractSystem::runRankWorker(const size_t &worker) -> void
+        {
+            while (true)
+            {
+                // 1. Wait for the next interval
+                m_phase_barrier->arriveAndWait();
+                if (m_workers_stop.load(std::memory_order_relaxed))
                 {
-                    futures.push_back(m_thread_pool->enqueue(
-                        [&]
-                        {
-                            auto &scheduler = it.second.scheduler;
-                            scheduler->run(m_bound_weave_interval, true, false);
-                            return !scheduler->isFinished();
-                        }));
+                    return;
                 }
-                // Wait for all tasks to complete
-                for (auto &f : futures)
+                // 2. Run the bound phase, then the weave phase once every bound rank is done
+                runPhaseEvent(m_bound_ranks, worker);
+                if (!m_weave_ranks.empty())
                 {
-                    if (f.get())
+                    m_phase_barrier->arriveAndWait();
+                    runPhaseEvent(m_weave_ranks, worker);
+                }
+                // 3. Report the end of the interval
+                m_phase_barrier->arriveAndWait();
+            }
+        };
+
+        auto AbstractSystem::runPhaseEvent(const std::vector<RankDomain_t *> &ranks, const size_t &worker) -> void
+        {
+            // Ranks are dealt to the workers round-robin, always the same ones to a worker
+            for (size_t i = worker; i < ranks.size(); i += m_rank_workers.size())
+            {
+                auto &rank_domain = *ranks[i];
+                try
+                {
+                    // A rank without events waits for a wakeup, its clock catches up when it is woken
+                    if (rank_domain.quiescent)
                     {
-                        finished = false;
+                        // Events also arrive from other ranks or units, not only through wakeups
+                        if (rank_domain.scheduler->isFinished())
+                        {
+                            rank_domain.skipped_ticks += m_bound_weave_interval;
+                            continue;
+                        }
+                        catchUpRank(rank_domain);
                     }
+                    rank_domain.scheduler->run(m_bound_weave_interval, true, false);
+                    rank_domain.quiescent = rank_domain.scheduler->isFinished();
+                }
+                catch (...)
+                {
+                    // The worker keeps crossing the barrier, the error is raised on the main thread
+                    m_worker_errors[worker] = std::current_exception();
                 }
-                futures.clear();
             }
-            return finished;
+        };
+
+        auto AbstractSystem::isPhaseFinished(const std::vector<RankDomain_t *> &ranks) const -> bool
+        {
+            return std::all_of(ranks.begin(), ranks.end(),
+                               [](const RankDomain_t *rank_domain)
+                               { return rank_domain->quiescent && rank_domain->scheduler->isFinished(); });
         };
 
         auto AbstractSystem::handleBoundWeaveEvent() -> void
         {
+            // Rank schedulers are idle, notified CPUs can be scheduled on them
+            drainWakeUps();
 
-            bool bound_phase_finished = runPhaseEvent(m_bound_phase);
-            bool weave_phase_finished = runPhaseEvent(m_weave_phase);
+            // Release the workers and wait for the end of the interval
+            m_phase_barrier->arriveAndWait();
+            if (!m_weave_ranks.empty())
+            {
+                m_phase_barrier->arriveAndWait();
+            }
+            m_phase_barrier->arriveAndWait();
+            for (auto &error : m_worker_errors)
+            {
+                if (SPARTA_EXPECT_FALSE(error != nullptr))
+                {
+                    std::rethrow_exception(std::exchange(error, nullptr));
+                }
+            }
+
+            bool bound_phase_finished = isPhaseFinished(m_bound_ranks);
+            bool weave_phase_finished = isPhaseFinished(m_weave_ranks);
 
-            if (bound_phase_finished && weave_phase_finished)
+            // Parked CPUs have no events scheduled but are not finished
+            if (bound_phase_finished && weave_phase_finished && m_parked_harts.load() == 0 && !m_wakeup_pending.load())
             {
                 m_main_scheduler->stopRunning();
                 m_main_scheduler->restartAt(m_main_scheduler->getCurrentTick() + m_bound_weave_interval - 1);
             }
             else
             {
+                if (bound_phase_finished && weave_phase_finished && m_main_scheduler->isFinished())
+                {
+                    // Nothing happens in any rank until a CPU is woken up, skip to the next wakeup
+                    waitForWakeUp();
+                }
                 m_bound_weave_event.scheduleRelativeTick(m_bound_weave_interval, m_main_scheduler);
             }
         };
 
+        auto AbstractSystem::requestWakeUp(cpu::AbstractCPU *cpu) -> void
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_wakeup_mutex);
+                m_wakeup_requests.push_back(cpu);
+                m_wakeup_pending.store(true, std::memory_order_release);
+            }
+            m_wakeup_cv.notify_one();
+        };
+
+        auto AbstractSystem::parkHart(cpu::AbstractCPU *cpu) -> void
+        {
+            if (cpu->m_parked)
+            {
+                return;
+            }
+            cpu->m_parked = true;
+            m_parked_harts++;
+            if (!m_bound_weave_enabled)
+            {
+                m_wakeup_drain_event.schedule();
+            }
+        };
+
+        auto AbstractSystem::wakeUpProcess(const Process *process) -> void
+        {
+            for (auto &cpu : m_cpus)
+            {
+                if (cpu->m_process == process)
+                {
+                    cpu->notifyWakeUp();
+                }
+            }
+        };
+
+        auto AbstractSystem::drainWakeUps() -> void
+        {
+            if (SPARTA_EXPECT_TRUE(!m_wakeup_pending.load(std::memory_order_acquire)))
+            {
+                return;
+            }
+            std::vector<cpu::AbstractCPU *> requests;
+            {
+                std::lock_guard<std::mutex> lock(m_wakeup_mutex);
+                requests.swap(m_wakeup_requests);
+                m_wakeup_pending.store(false, std::memory_order_relaxed);
+            }
+            for (auto &cpu : requests)
+            {
+                // Later notifications queue the cpu again
+                cpu->m_wakeup_requested.store(false, std::memory_order_release);
+                // A cpu that is not parked either runs or has its check scheduled already
+                if (cpu->m_parked)
+                {
+                    cpu->m_parked = false;
+                    m_parked_harts--;
+                    // The check is scheduled relative to the clock of its rank, which must be current
+                    auto rank = m_rank_of_scheduler.find(cpu->getClock()->getScheduler());
+                    if (rank != m_rank_of_scheduler.end())
+                    {
+                        catchUpRank(*rank->second);
+                    }
+                    cpu->scheduleWakeUpMonitorEvent();
+                }
+            }
+        };
+
+        auto AbstractSystem::waitForWakeUp() -> void
+        {
+            m_quiescence_waiter.setPolicy(m_wait_policy);
+            m_quiescence_waiter.wait([this]() { return m_wakeup_pending.load(std::memory_order_acquire); },
+                                     [this](const std::chrono::microseconds &timeout)
+                                     {
+                                         std::unique_lock<std::mutex> lock(m_wakeup_mutex);
+                                         m_wakeup_cv.wait_for(lock, timeout, [this]() { return m_wakeup_pending.load(); });
+                                     });
+        };
+
+        auto AbstractSystem::catchUpRank(RankDomain_t &rank_domain) -> void
+        {
+            // Without events the scheduler only moves its clock forward
+            if (rank_domain.skipped_ticks > 0)
+            {
+                rank_domain.scheduler->run(rank_domain.skipped_ticks, true, false);
+                rank_domain.skipped_ticks = 0;
+            }
+            rank_domain.quiescent = false;
+        };
+
+        auto AbstractSystem::handleWakeUpDrainEvent() -> void
+        {
+            // Every parked CPU waits for a wakeup and nothing else is scheduled, skip to the next wakeup
+            if (m_parked_harts.load() > 0 && m_main_scheduler->isFinished())
+            {
+                waitForWakeUp();
+            }
+            drainWakeUps();
+            if (m_parked_harts.load() > 0)
+            {
+                m_wakeup_drain_event.schedule();
+            }
+        };
+
         auto AbstractSystem::buildRank(RankDomain_t &rank_domain) -> void
         {
             rank_domain.scheduler = std::make_unique<sparta::Scheduler>("Scheduler" + rank_domain.name);
@@ -176,6 +375,7 @@ namespace archXplore
                 }
             }
             rank_domain.clock_manager->normalize();
+            m_rank_of_scheduler[rank_domain.scheduler.get()] = &rank_domain;
         };
 
         auto AbstractSystem::buildClockDomains() -> void
@@ -218,6 +418,14 @@ namespace archXplore
                               "Relative tick must be a multiple of bound weave interval\n");
             }
             m_main_scheduler->run(tick, true, false);
+            // Skipped ranks are brought to the time of the system before control returns
+            for (auto &it : m_rank_of_scheduler)
+            {
+                if (it.second != &m_schedule_phase)
+                {
+                    catchUpRank(*it.second);
+                }
+            }
         }
 
         auto AbstractSystem::getElapsedTime() const -> double
@@ -0,0 +1,226 @@
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "iss/champsim/ChampSimReader.hpp"
+
+using namespace archXplore;
+using iss::champsim::ChampSimReader;
+using iss::champsim::ChampSimRecord_t;
+
+// Records after the handcrafted ones, enough to cross the first batch of the reader
+static constexpr size_t NUM_RECORDS = ChampSimReader::RECORD_BATCH + 64;
+// Start of the sequential filler records
+static constexpr Addr_t FILLER_BASE = 0x10000;
+// Length of the instruction ending the first batch, only known from the next batch
+static constexpr Addr_t BOUNDARY_LEN = 6;
+// Load address of the instruction ending the first batch
+static constexpr Addr_t BOUNDARY_LOAD = 0xb000;
+
+/*
+ * @brief Expected decoding of a handcrafted record
+ */
+struct Expected_t
+{
+    Addr_t pc;
+    uint8_t len;
+    bool redirect;
+    Addr_t target_pc;
+    cpu::FunctionInfo_t func;
+    Addr_t vaddr;
+    bool is_store;
+};
+
+static auto record(const Addr_t &ip, std::vector<uint8_t> src = {}, std::vector<uint8_t> dst = {}) -> ChampSimRecord_t
+{
+    ChampSimRecord_t r{};
+    r.ip = ip;
+    for (size_t i = 0; i < src.size(); ++i)
+    {
+        r.source_registers[i] = src[i];
+    }
+    for (size_t i = 0; i < dst.size(); ++i)
+    {
+        r.destination_registers[i] = dst[i];
+    }
+    return r;
+}
+
+static auto branch(const Addr_t &ip, const bool &taken, std::vector<uint8_t> src, std::vector<uint8_t> dst)
+    -> ChampSimRecord_t
+{
+    ChampSimRecord_t r = record(ip, src, dst);
+    r.is_branch = 1;
+    r.branch_taken = taken;
+    return r;
+}
+
+/**
+ * @brief Build the records and their expected instructions
+ * @param records Records of the trace
+ * @param expected Expected instruction of each record
+ *
+ * @return void
+ */
+static auto build(std::vector<ChampSimRecord_t> &records, std::vector<Expected_t> &expected) -> void
+{
+    const uint8_t SP = ChampSimReader::REG_STACK_POINTER;
+    const uint8_t FLAGS = ChampSimReader::REG_FLAGS;
+    const uint8_t IP = ChampSimReader::REG_INSTRUCTION_POINTER;
+    const uint8_t LEN = ChampSimReader::DEFAULT_INST_LEN;
+
+    // Plain instruction, the length is the distance to the next record
+    records.push_back(record(0x1000, {1, 2}, {3}));
+    expected.push_back({0x1000, 3, false, 0x1003, cpu::TYPE_ALU, 0, false});
+    // Loads win over stores
+    ChampSimRecord_t load = record(0x1003, {1}, {2});
+    load.source_memory[1] = 0x8000;
+    load.destination_memory[0] = 0x9000;
+    records.push_back(load);
+    expected.push_back({0x1003, 4, false, 0x1007, cpu::TYPE_LOAD, 0x8000, false});
+    // Store from any destination slot
+    ChampSimRecord_t store = record(0x1007, {1, 2});
+    store.destination_memory[1] = 0x9008;
+    records.push_back(store);
+    expected.push_back({0x1007, 3, false, 0x100a, cpu::TYPE_STORE, 0x9008, true});
+    // Taken conditional branch, the length of a redirected instruction is unknown
+    records.push_back(branch(0x100a, true, {IP, FLAGS}, {IP}));
+    expected.push_back({0x100a, LEN, true, 0x2000, cpu::TYPE_BRANCH, 0, false});
+    // Direct jump
+    records.push_back(branch(0x2000, true, {}, {IP}));
+    expected.push_back({0x2000, LEN, true, 0x3000, cpu::TYPE_JUMP, 0, false});
+    // Indirect jump
+    records.push_back(branch(0x3000, true, {5}, {IP}));
+    expected.push_back({0x3000, LEN, true, 0x4000, cpu::TYPE_JUMP_REG, 0, false});
+    // Call, backwards to the return
+    records.push_back(branch(0x4000, true, {SP, IP}, {SP, IP}));
+    expected.push_back({0x4000, LEN, true, 0x3800, cpu::TYPE_CALL, 0, false});
+    // Return
+    records.push_back(branch(0x3800, true, {SP}, {SP, IP}));
+    expected.push_back({0x3800, LEN, true, 0x4005, cpu::TYPE_RETURN, 0, false});
+    // Not taken conditional branch falls through
+    records.push_back(branch(0x4005, false, {IP, FLAGS}, {IP}));
+    expected.push_back({0x4005, 2, false, 0x4007, cpu::TYPE_BRANCH, 0, false});
+    // Branch reading flags and another register matches no ChampSim type
+    records.push_back(branch(0x4007, false, {IP, FLAGS, 5}, {IP}));
+    expected.push_back({0x4007, LEN, false, 0x400b, cpu::TYPE_OTHER, 0, false});
+    // A fall-through longer than any instruction is a redirect
+    records.push_back(record(0x400b));
+    expected.push_back({0x400b, LEN, true, FILLER_BASE, cpu::TYPE_ALU, 0, false});
+
+    // Fillers up to the end of the first batch
+    Addr_t pc = FILLER_BASE;
+    while (records.size() < ChampSimReader::RECORD_BATCH)
+    {
+        records.push_back(record(pc, {1}, {2}));
+        expected.push_back({pc, 4, false, pc + 4, cpu::TYPE_ALU, 0, false});
+        pc += 4;
+    }
+    // The last record of the first batch learns its length from the second batch
+    ChampSimRecord_t boundary = record(pc, {1}, {2});
+    boundary.source_memory[0] = BOUNDARY_LOAD;
+    records.push_back(boundary);
+    expected.push_back({pc, BOUNDARY_LEN, false, pc + BOUNDARY_LEN, cpu::TYPE_LOAD, BOUNDARY_LOAD, false});
+    pc += BOUNDARY_LEN;
+    // Fillers up to the end of the trace
+    while (records.size() < NUM_RECORDS)
+    {
+        records.push_back(record(pc, {1}, {2}));
+        expected.push_back({pc, 4, false, pc + 4, cpu::TYPE_ALU, 0, false});
+        pc += 4;
+    }
+    // Nothing follows the last record
+    expected.back().len = LEN;
+    expected.back().target_pc = expected.back().pc + LEN;
+}
+
+/**
+ * @brief Decode a trace and compare it with the expected instructions
+ * @param path Path of the trace
+ * @param expected Expected instruction of each record
+ * @return Number of mismatches
+ */
+static auto check(const std::string &path, const std::vector<Expected_t> &expected) -> size_t
+{
+    ChampSimReader reader(path);
+    std::vector<cpu::StaticInst_t> insts;
+    // Reads of odd size do not line up with the batches of the reader
+    while (reader.read(insts, 333) > 0)
+    {
+        continue;
+    }
+    size_t errors = 0;
+    if (insts.size() != expected.size())
+    {
+        std::cerr << path << ": decoded " << insts.size() << " instructions instead of " << expected.size() << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < insts.size(); ++i)
+    {
+        const cpu::StaticInst_t &inst = insts[i];
+        const Expected_t &e = expected[i];
+        const bool has_mem = e.func == cpu::TYPE_LOAD || e.func == cpu::TYPE_STORE;
+        const bool ok = inst.uid == i && inst.pc == e.pc && inst.len == e.len &&
+                        inst.br_info.redirect == e.redirect && inst.br_info.target_pc == e.target_pc &&
+                        inst.func_info == e.func &&
+                        (!has_mem || (inst.mem_info.vaddr == e.vaddr && inst.mem_info.is_store == e.is_store &&
+                                      inst.mem_info.len == ChampSimReader::MEM_SIZE_SHIFT));
+        if (!ok)
+        {
+            std::cerr << path << ": record " << i << " at 0x" << std::hex << inst.pc << " decoded as len "
+                      << std::dec << int(inst.len) << ", redirect " << inst.br_info.redirect << " to 0x" << std::hex
+                      << inst.br_info.target_pc << ", type " << std::dec << int(inst.func_info) << ", memory 0x"
+                      << std::hex << inst.mem_info.vaddr << std::dec << std::endl;
+            errors++;
+        }
+    }
+    return errors;
+}
+
+int main(int argc, char const *argv[])
+{
+    std::vector<ChampSimRecord_t> records;
+    std::vector<Expected_t> expected;
+    build(records, expected);
+
+    const std::string path = "/tmp/champsim_reader_test_" + std::to_string(::getpid()) + ".trace";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(ChampSimRecord_t));
+        if (!out)
+        {
+            std::cerr << "Unable to write " << path << std::endl;
+            return 1;
+        }
+    }
+    // The compressed copy goes through the decompressor of the prefetch reader
+    if (std::system(("gzip -c " + path + " > " + path + ".gz").c_str()) != 0)
+    {
+        ::unlink(path.c_str());
+        std::cerr << "Unable to compress " << path << std::endl;
+        return 1;
+    }
+
+    size_t errors = 0;
+    try
+    {
+        errors += check(path, expected);
+        errors += check(path + ".gz", expected);
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << "Reader stopped: " << e.what() << std::endl;
+        errors++;
+    }
+    ::unlink(path.c_str());
+    ::unlink((path + ".gz").c_str());
+
+    std::cout << "Records: " << records.size() << std::endl;
+    std::cout << "Mismatches: " << errors << std::endl;
+    std::cout << (errors == 0 ? "PASSED" : "FAILED") << std::endl;
+    return errors == 0 ? 0 : 1;
+}
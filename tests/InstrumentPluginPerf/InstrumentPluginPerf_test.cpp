@@ -0,0 +1,147 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "iss/qemu/instrumentation/InstrumentPlugin.hpp"
+
+#define NUM_STATIC_INSTS 4096
+#define NUM_EXEC_INSTS 10000000
+#define MAX_VCPUS 64
+
+using namespace archXplore;
+using iss::qemu::InstrumentPlugin;
+
+// Plugin state used by the instruction callback, defined by the plugin library otherwise
+std::unique_ptr<InstrumentPlugin::VCPUState_t[]> InstrumentPlugin::m_vcpu_states;
+std::mutex InstrumentPlugin::m_shared_resource_mutex;
+
+// Legacy path: global map guarded by a shared mutex, looked up before the callback runs
+std::unordered_map<Addr_t, InstrumentPlugin::InstDescriptor_t> inst_cache;
+std::shared_mutex inst_cache_mutex;
+
+void legacyCallback(unsigned int vcpu_index, void *userdata)
+{
+    InstrumentPlugin::InstDescriptor_t inst;
+    {
+        std::shared_lock<std::shared_mutex> lock(inst_cache_mutex);
+        inst = inst_cache[(Addr_t)userdata];
+    }
+    InstrumentPlugin::executeInstruction(vcpu_index, &inst);
+}
+
+// Legacy per-vCPU state: one map per field, hashed on every callback
+struct MapState_t
+{
+    std::unordered_map<HartID_t, EventID_t> inst_counters;
+    std::unordered_map<HartID_t, EventID_t> event_counters;
+    std::unordered_map<HartID_t, cpu::StaticInst_t> last_insts;
+};
+
+MapState_t map_states;
+
+void mapStateCallback(unsigned int vcpu_index, void *userdata)
+{
+    const InstrumentPlugin::InstDescriptor_t &inst = *(const InstrumentPlugin::InstDescriptor_t *)userdata;
+    cpu::StaticInst_t &last_inst = map_states.last_insts.at(vcpu_index);
+    EventID_t &inst_counter = map_states.inst_counters.at(vcpu_index);
+    if (inst_counter != 0)
+    {
+        last_inst.br_info.target_pc = inst.pc;
+        last_inst.br_info.redirect = (last_inst.pc + last_inst.len != inst.pc);
+        map_states.event_counters.at(vcpu_index)++;
+    }
+    last_inst.uid = inst_counter++;
+    last_inst.pc = inst.pc;
+    last_inst.opcode = inst.opcode;
+    last_inst.len = inst.len;
+}
+
+/**
+ * @brief Run a callback on several host threads, each one driving a vCPU
+ * @param userdata Userdata of the executed instructions
+ * @param num_threads Number of vCPUs
+ * @param callback Instruction execution callback
+ * @return Wall time per callback of a single vCPU in nanoseconds
+ */
+template <typename Callback>
+double measure(const std::vector<void *> &userdata, const size_t &num_threads, Callback callback)
+{
+    // Fresh plugin state, without publisher or trace recorder the callbacks stay in the process
+    InstrumentPlugin::m_vcpu_states.reset(new InstrumentPlugin::VCPUState_t[MAX_VCPUS]);
+    map_states = MapState_t();
+    for (size_t t = 0; t < num_threads; ++t)
+    {
+        map_states.inst_counters[t] = 0;
+        map_states.event_counters[t] = 0;
+        map_states.last_insts[t] = cpu::StaticInst_t{};
+    }
+
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (size_t t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&, t]
+                             {
+            for (size_t i = 0; i < NUM_EXEC_INSTS; ++i)
+            {
+                callback(t, userdata[i % userdata.size()]);
+            } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    auto stop = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start);
+
+    // Callbacks run concurrently, so report wall time per callback of a single vCPU
+    return double(duration.count()) / NUM_EXEC_INSTS;
+}
+
+int main(int argc, char const *argv[])
+{
+    utils::Arena<InstrumentPlugin::InstDescriptor_t> arena;
+
+    std::vector<void *> legacy_userdata;
+    std::vector<void *> descriptor_userdata;
+
+    for (size_t i = 0; i < NUM_STATIC_INSTS; ++i)
+    {
+        InstrumentPlugin::InstDescriptor_t desc{0x10000 + i * 4, uint32_t(i), 4};
+        inst_cache[desc.pc] = desc;
+        legacy_userdata.push_back((void *)desc.pc);
+        descriptor_userdata.push_back(arena.create(desc));
+    }
+
+    std::cout << "Static instructions: " << NUM_STATIC_INSTS << std::endl;
+    std::cout << "Executed instructions per vCPU: " << NUM_EXEC_INSTS << std::endl;
+
+    for (size_t num_threads : {1, 8, MAX_VCPUS})
+    {
+        double legacy_ns = measure(legacy_userdata, num_threads, legacyCallback);
+        double descriptor_ns = measure(descriptor_userdata, num_threads, InstrumentPlugin::executeInstruction);
+        std::cout << "vCPUs: " << num_threads
+                  << ", map + shared_mutex: " << legacy_ns << " ns/inst"
+                  << ", arena descriptor: " << descriptor_ns << " ns/inst"
+                  << ", speedup: " << legacy_ns / descriptor_ns << "x" << std::endl;
+    }
+
+    for (size_t num_threads : {1, 8, MAX_VCPUS})
+    {
+        double map_ns = measure(descriptor_userdata, num_threads, mapStateCallback);
+        double array_ns = measure(descriptor_userdata, num_threads, InstrumentPlugin::executeInstruction);
+        std::cout << "vCPUs: " << num_threads
+                  << ", per-field maps: " << map_ns << " ns/inst"
+                  << ", padded state array: " << array_ns << " ns/inst"
+                  << ", speedup: " << map_ns / array_ns << "x" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "iss/EventPublisher.hpp"
+#include "iss/EventSubscriber.hpp"
+#include "iss/FetchGroup.hpp"
+
+#include "iceoryx_posh/runtime/posh_runtime.hpp"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Instructions fetched in place before the block record chain
+#define numInsts 8
+// Records of the block chain, each one published in its own chunk
+#define numRecords 3
+// Events published afterwards so that the chunks of the fetched instructions are reused
+#define numFillers 1024
+
+using archXplore::cpu::BlockEvent_t;
+using archXplore::cpu::StaticInst_t;
+using archXplore::cpu::ThreadEvent_t;
+
+static auto makeInst(const uint64_t &pc) -> StaticInst_t
+{
+    StaticInst_t inst{};
+    inst.uid = pc;
+    inst.pc = pc;
+    inst.opcode = 0x13;
+    inst.len = 4;
+    return inst;
+}
+
+static auto publish() -> void
+{
+    auto publisher = archXplore::iss::EventPublisher("BLOCK_SPAN", 0);
+
+    archXplore::EventID_t event_id = 0;
+    for (int i = 0; i < numInsts; i++)
+    {
+        publisher.publish(i == numInsts - 1, ThreadEvent_t::InsnTag, event_id++, makeInst(0x1000 + 4 * i));
+    }
+    for (int i = 0; i < numRecords; i++)
+    {
+        BlockEvent_t block{};
+        block.block_id = 1;
+        block.has_more = i != numRecords - 1;
+        publisher.publish(true, ThreadEvent_t::BlockTag, event_id++, block);
+    }
+    for (int i = 0; i < numFillers; i++)
+    {
+        ThreadEvent_t event(ThreadEvent_t::InsnTag, event_id++, makeInst(0xdead0000));
+        event.is_last = i == numFillers - 1;
+        publisher.publish(true, event);
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    // Initialize Posh runtime
+    iox::runtime::PoshRuntime::initRuntime("iox-cpp-block-span");
+
+    // The publisher and the subscriber each wait for the other one
+    std::thread publisher(publish);
+    auto subscriber = archXplore::iss::EventSubscriber("BLOCK_SPAN", 0);
+
+    // Fetch the instructions in place, as the QEMU ISS does
+    archXplore::iss::FetchPackage package;
+    int fetched = 0;
+    while (fetched < numInsts)
+    {
+        auto batch = subscriber.nextBatch(numInsts - fetched, package);
+        for (auto &event : batch)
+        {
+            package.append(event.instruction, sizeof(ThreadEvent_t));
+        }
+        fetched += batch.size();
+        subscriber.release(batch.size());
+    }
+
+    // Follow the block record chain across its chunks
+    int records = 0;
+    bool has_more = true;
+    while (has_more)
+    {
+        auto &event = subscriber.nextBatch(1, package)[0];
+        has_more = event.block.has_more;
+        subscriber.release(1);
+        records++;
+    }
+
+    // Consume the fillers, the publisher writes them into the released chunks
+    bool is_last = false;
+    while (!is_last)
+    {
+        auto batch = subscriber.nextBatch(64, package);
+        for (auto &event : batch)
+        {
+            is_last |= event.is_last;
+        }
+        subscriber.release(batch.size());
+    }
+
+    subscriber.shutdown();
+    publisher.join();
+
+    auto group = package.group();
+    bool passed = records == numRecords && group.size() == numInsts;
+    for (size_t i = 0; passed && i < group.size(); i++)
+    {
+        passed = group[i].pc == 0x1000 + 4 * i;
+    }
+
+    std::cout << "Block records: " << records << std::endl;
+    std::cout << "Fetched instructions: " << group.size() << std::endl;
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+
+    return passed ? 0 : 1;
+}
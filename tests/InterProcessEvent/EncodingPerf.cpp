@@ -0,0 +1,180 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+
+#include "iss/EventCodec.hpp"
+
+#define numElements 10000000
+
+using namespace archXplore;
+
+// Synthetic instruction stream shaped like the plugin output: mostly fall-through,
+// a taken branch every few instructions, loads and stores with strided addresses
+std::vector<cpu::ThreadEvent_t> generateEvents()
+{
+    std::mt19937_64 rng(42);
+    std::vector<cpu::ThreadEvent_t> events;
+    events.reserve(numElements);
+
+    cpu::StaticInst_t inst{};
+    Addr_t pc = 0x10000;
+    Addr_t stack = 0x7ffff000;
+    EventID_t event_id = 0;
+    for (EventID_t uid = 0; uid < numElements; ++uid)
+    {
+        inst.uid = uid;
+        inst.pc = pc;
+        inst.len = (rng() % 4 == 0) ? 2 : 4;
+        inst.opcode = inst.len == 2 ? uint32_t(rng() & 0xffff) : uint32_t(rng());
+        Addr_t next_pc = pc + inst.len;
+        if (rng() % 6 == 0)
+        {
+            next_pc = 0x10000 + (rng() % 0x10000) * 2;
+        }
+        inst.br_info.target_pc = next_pc;
+        inst.br_info.redirect = (next_pc != pc + inst.len);
+        if (rng() % 3 == 0)
+        {
+            inst.mem_info.vaddr = stack + (rng() % 64) * 8;
+            inst.mem_info.len = 3;
+            inst.mem_info.is_store = rng() % 2;
+        }
+        events.emplace_back(cpu::ThreadEvent_t::InsnTag, event_id++, inst);
+        if (rng() % 10000 == 0)
+        {
+            events.emplace_back(cpu::ThreadEvent_t::SyscallApiTag, event_id++, cpu::SyscallAPI_t());
+        }
+        pc = next_pc;
+    }
+    events.back().is_last = true;
+    return events;
+}
+
+static bool sameRegister(const cpu::RegisterInfo_t &a, const cpu::RegisterInfo_t &b)
+{
+    return a.type == b.type && a.id == b.id;
+}
+
+// Field-wise comparison, padding bytes of the union are not part of the event
+static bool sameEvent(const cpu::ThreadEvent_t &a, const cpu::ThreadEvent_t &b)
+{
+    if (a.tag != b.tag || a.event_id != b.event_id || a.is_last != b.is_last)
+    {
+        return false;
+    }
+    if (a.tag == cpu::ThreadEvent_t::Tag::SYSCALL_API)
+    {
+        return a.syscall_api.api_type == b.syscall_api.api_type;
+    }
+    const cpu::StaticInst_t &x = a.instruction;
+    const cpu::StaticInst_t &y = b.instruction;
+    return x.uid == y.uid && x.pc == y.pc && x.opcode == y.opcode && x.len == y.len &&
+           sameRegister(x.src_reg1, y.src_reg1) && sameRegister(x.src_reg2, y.src_reg2) &&
+           sameRegister(x.src_reg3, y.src_reg3) && sameRegister(x.dst_reg, y.dst_reg) &&
+           x.func_info == y.func_info &&
+           x.br_info.redirect == y.br_info.redirect && x.br_info.target_pc == y.br_info.target_pc &&
+           x.mem_info.vaddr == y.mem_info.vaddr && x.mem_info.len == y.mem_info.len &&
+           x.mem_info.is_store == y.mem_info.is_store;
+}
+
+int main(int argc, char const *argv[])
+{
+    const auto events = generateEvents();
+    const size_t chunk_bytes = iss::MESSAGE_VECTOR_SIZE * sizeof(cpu::ThreadEvent_t);
+    std::vector<uint8_t> chunk(chunk_bytes);
+
+    // Raw encoding: a chunk holds a fixed number of events
+    const double raw_per_chunk = iss::MESSAGE_VECTOR_SIZE;
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t raw_checksum = 0;
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        auto slot = reinterpret_cast<cpu::ThreadEvent_t *>(chunk.data()) + i % iss::MESSAGE_VECTOR_SIZE;
+        new (slot) cpu::ThreadEvent_t(events[i]);
+        raw_checksum += slot->event_id;
+    }
+    auto stop = std::chrono::high_resolution_clock::now();
+    const double raw_ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()) / events.size();
+
+    // Delta encoding: fill chunks until the encoder reports full or the publisher's
+    // batch limit is reached, then decode them
+    const size_t max_delta_events = iss::MESSAGE_VECTOR_SIZE * iss::EventEncoder::EVENTS_PER_SLOT;
+    iss::EventEncoder encoder;
+    iss::EventDecoder decoder;
+    size_t num_chunks = 0;
+    size_t decoded = 0;
+    size_t delta_checksum = 0;
+    std::chrono::nanoseconds encode_time(0);
+    std::chrono::nanoseconds decode_time(0);
+    size_t next = 0;
+    while (next < events.size())
+    {
+        auto encode_start = std::chrono::high_resolution_clock::now();
+        encoder.reset(chunk.data(), chunk_bytes);
+        size_t num_events = 0;
+        while (next < events.size() && !encoder.full() && num_events < max_delta_events)
+        {
+            encoder.encode(events[next++]);
+            num_events++;
+        }
+        auto decode_start = std::chrono::high_resolution_clock::now();
+        for (decoder.reset(chunk.data(), num_events); !decoder.empty(); decoder.next())
+        {
+            delta_checksum += decoder.current().event_id;
+            decoded++;
+        }
+        auto decode_stop = std::chrono::high_resolution_clock::now();
+        encode_time += decode_start - encode_start;
+        decode_time += decode_stop - decode_start;
+        num_chunks++;
+    }
+    const double delta_per_chunk = double(events.size()) / num_chunks;
+
+    if (decoded != events.size() || delta_checksum != raw_checksum)
+    {
+        std::cout << "Decoded stream does not match the input" << std::endl;
+        return 1;
+    }
+
+    // Untimed round trip comparing every decoded event with its input
+    next = 0;
+    while (next < events.size())
+    {
+        const size_t first = next;
+        encoder.reset(chunk.data(), chunk_bytes);
+        size_t num_events = 0;
+        while (next < events.size() && !encoder.full() && num_events < max_delta_events)
+        {
+            encoder.encode(events[next++]);
+            num_events++;
+        }
+        size_t i = first;
+        for (decoder.reset(chunk.data(), num_events); !decoder.empty(); decoder.next(), ++i)
+        {
+            if (!sameEvent(decoder.current(), events[i]))
+            {
+                std::cout << "Event " << i << " does not round trip: " << events[i].instruction.serialize()
+                          << " decoded as " << decoder.current().instruction.serialize() << std::endl;
+                return 1;
+            }
+        }
+        if (i != next)
+        {
+            std::cout << "Chunk at event " << first << " decoded " << i - first << " of "
+                      << num_events << " events" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Elements size: " << events.size() << std::endl;
+    std::cout << "Chunk size: " << chunk_bytes << " bytes" << std::endl;
+    std::cout << "Raw: " << raw_per_chunk << " events/chunk, "
+              << raw_ns << " ns/event" << std::endl;
+    std::cout << "Delta: " << delta_per_chunk << " events/chunk, "
+              << double(encode_time.count()) / events.size() << " ns/event encode, "
+              << double(decode_time.count()) / events.size() << " ns/event decode" << std::endl;
+    std::cout << "Events per chunk gain: " << delta_per_chunk / raw_per_chunk << "x" << std::endl;
+
+    return 0;
+}
@@ -19,19 +19,16 @@ int main(int argc, char const *argv[])
 
     auto start = std::chrono::high_resolution_clock::now();
 
-    while (!iox::hasTerminationRequested())
+    bool is_last = false;
+    while (!is_last && !iox::hasTerminationRequested())
     {
-        auto &event = subscriber.front();
-        if (event.is_last)
+        auto batch = subscriber.nextBatch(batchSize);
+        for (auto &event : batch)
         {
-            subscriber.popFront();
-            break;
+            is_last |= event.is_last;
+            // std::cout << "Received event: " << event.event_id << std::endl;
         }
-        else
-        {
-            subscriber.popFront();
-        }
-        // std::cout << "Received event: " << event.event_id << std::endl;
+        subscriber.release(batch.size());
     }
 
     return 0;
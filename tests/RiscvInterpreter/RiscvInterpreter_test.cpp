@@ -0,0 +1,500 @@
+#include <elf.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "iss/riscv/RiscvInterpreter.hpp"
+
+using namespace archXplore;
+
+// Load address of the code segment
+static constexpr Addr_t CODE_BASE = 0x10000;
+// Load address of the data segment, held in x31 by the guest
+static constexpr Addr_t DATA_BASE = 0x40000;
+// Size of the data segment
+static constexpr uint64_t DATA_SIZE = 0x1000;
+// Scratch words of the atomic checks
+static constexpr uint64_t SCRATCH_OFFSET = 0x400;
+// Strings used by the syscall checks
+static constexpr uint64_t STRING_OFFSET = 0x600;
+
+// Written to stdout by the guest
+static const char *const GUEST_MESSAGE = "RiscvInterpreter guest says hello\n";
+
+// Registers
+static constexpr uint32_t X0 = 0, RA = 1, SP = 2, T0 = 5, T1 = 6, T2 = 7, S0 = 8, S1 = 9;
+static constexpr uint32_t A0 = 10, A1 = 11, A2 = 12, A3 = 13, A5 = 15, A7 = 17, BASE = 31;
+
+/**
+ * @brief Assembles the guest program
+ *
+ * Every check compares a register against a constant of the data segment and
+ * exits with the number of the check when they differ, so the exit code of the
+ * guest names the first failing check.
+ */
+class Assembler
+{
+public:
+    auto pc() const -> Addr_t
+    {
+        return CODE_BASE + m_code.size();
+    };
+
+    auto half(const uint16_t &c) -> void
+    {
+        m_compressed.insert(pc());
+        m_code.push_back(c & 0xff);
+        m_code.push_back(c >> 8);
+    };
+
+    auto word(const uint32_t &w) -> void
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            m_code.push_back((w >> (8 * i)) & 0xff);
+        }
+    };
+
+    auto r(uint32_t f7, uint32_t rs2, uint32_t rs1, uint32_t f3, uint32_t rd, uint32_t op) -> void
+    {
+        word(f7 << 25 | rs2 << 20 | rs1 << 15 | f3 << 12 | rd << 7 | op);
+    };
+
+    auto i(int64_t imm, uint32_t rs1, uint32_t f3, uint32_t rd, uint32_t op) -> void
+    {
+        word(uint32_t(imm & 0xfff) << 20 | rs1 << 15 | f3 << 12 | rd << 7 | op);
+    };
+
+    static auto b(int64_t imm, uint32_t rs2, uint32_t rs1, uint32_t f3) -> uint32_t
+    {
+        return uint32_t((imm >> 12) & 1) << 31 | uint32_t((imm >> 5) & 0x3f) << 25 | rs2 << 20 | rs1 << 15 |
+               f3 << 12 | uint32_t((imm >> 1) & 0xf) << 8 | uint32_t((imm >> 11) & 1) << 7 | 0x63;
+    };
+
+    static auto j(int64_t imm, uint32_t rd) -> uint32_t
+    {
+        return uint32_t((imm >> 20) & 1) << 31 | uint32_t((imm >> 1) & 0x3ff) << 21 |
+               uint32_t((imm >> 11) & 1) << 20 | uint32_t((imm >> 12) & 0xff) << 12 | rd << 7 | 0x6f;
+    };
+
+    auto addi(uint32_t rd, uint32_t rs1, int64_t imm) -> void
+    {
+        i(imm, rs1, 0, rd, 0x13);
+    };
+
+    auto ld(uint32_t rd, uint32_t rs1, int64_t imm) -> void
+    {
+        i(imm, rs1, 3, rd, 0x03);
+    };
+
+    auto ecall() -> void
+    {
+        word(0x00000073);
+    };
+
+    // Atomic memory operation, rs1 holds the address
+    auto amo(uint32_t f5, uint32_t f3, uint32_t rd, uint32_t rs1, uint32_t rs2) -> void
+    {
+        r(f5 << 2, rs2, rs1, f3, rd, 0x2f);
+    };
+
+    // Branch to an address known now, the target is recorded when the branch is taken
+    auto branch(uint32_t f3, uint32_t rs1, uint32_t rs2, const Addr_t &target, const bool &taken = true) -> void
+    {
+        if (taken)
+        {
+            m_targets[pc()] = target;
+        }
+        word(b(int64_t(target - pc()), rs2, rs1, f3));
+    };
+
+    // Jump forward to a label placed later, the link goes to rd
+    auto jal(uint32_t rd) -> size_t
+    {
+        m_fixups.emplace_back(m_code.size(), rd);
+        word(0);
+        return m_fixups.size() - 1;
+    };
+
+    auto jal(uint32_t rd, const Addr_t &target) -> void
+    {
+        m_targets[pc()] = target;
+        word(j(int64_t(target - pc()), rd));
+    };
+
+    // Place the target of a forward jump
+    auto bind(const size_t &fixup) -> void
+    {
+        const size_t at = m_fixups[fixup].first;
+        const Addr_t from = CODE_BASE + at;
+        m_targets[from] = pc();
+        const uint32_t w = j(int64_t(pc() - from), m_fixups[fixup].second);
+        std::memcpy(m_code.data() + at, &w, sizeof(w));
+    };
+
+    // Load a 64-bit constant from the data segment
+    auto li(uint32_t rd, const uint64_t &value) -> void
+    {
+        m_data.push_back(value);
+        ld(rd, BASE, int64_t(8 * (m_data.size() - 1)));
+    };
+
+    // Exit with the number of this check unless reg equals value
+    auto check(const std::string &name, uint32_t reg, const uint64_t &value) -> void
+    {
+        m_checks.push_back(name);
+        li(T1, value);
+        addi(A0, X0, int64_t(m_checks.size()));
+        word(b(8, T1, reg, 0));
+        m_fails.push_back(m_code.size());
+        word(0);
+    };
+
+    // Exit with a0, every failing check jumps here
+    auto fail() -> void
+    {
+        for (auto &at : m_fails)
+        {
+            const uint32_t w = j(int64_t(CODE_BASE + m_code.size() - (CODE_BASE + at)), X0);
+            std::memcpy(m_code.data() + at, &w, sizeof(w));
+        }
+        addi(A7, X0, 93);
+        ecall();
+    };
+
+    /**
+     * @brief Write the program as a static RV64 executable
+     * @param path Path of the executable
+     * @param strings Bytes placed at STRING_OFFSET of the data segment
+     * @return True when the file was written
+     */
+    auto write(const std::string &path, const std::string &strings) const -> bool
+    {
+        const uint64_t code_offset = 0x1000;
+        const uint64_t data_offset = code_offset + ((m_code.size() + 0xfff) & ~uint64_t(0xfff));
+        std::vector<uint8_t> data(DATA_SIZE, 0);
+        if (m_data.size() * 8 > SCRATCH_OFFSET || strings.size() > DATA_SIZE - STRING_OFFSET)
+        {
+            return false;
+        }
+        std::memcpy(data.data(), m_data.data(), m_data.size() * 8);
+        std::memcpy(data.data() + STRING_OFFSET, strings.data(), strings.size());
+
+        Elf64_Ehdr ehdr{};
+        std::memcpy(ehdr.e_ident, ELFMAG, SELFMAG);
+        ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+        ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+        ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+        ehdr.e_type = ET_EXEC;
+        ehdr.e_machine = EM_RISCV;
+        ehdr.e_version = EV_CURRENT;
+        ehdr.e_entry = CODE_BASE;
+        ehdr.e_phoff = sizeof(Elf64_Ehdr);
+        ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+        ehdr.e_phentsize = sizeof(Elf64_Phdr);
+        ehdr.e_phnum = 2;
+
+        Elf64_Phdr phdr[2] = {};
+        phdr[0].p_type = PT_LOAD;
+        phdr[0].p_flags = PF_R | PF_X;
+        phdr[0].p_offset = code_offset;
+        phdr[0].p_vaddr = phdr[0].p_paddr = CODE_BASE;
+        phdr[0].p_filesz = phdr[0].p_memsz = m_code.size();
+        phdr[0].p_align = 0x1000;
+        phdr[1].p_type = PT_LOAD;
+        phdr[1].p_flags = PF_R | PF_W;
+        phdr[1].p_offset = data_offset;
+        phdr[1].p_vaddr = phdr[1].p_paddr = DATA_BASE;
+        phdr[1].p_filesz = phdr[1].p_memsz = DATA_SIZE;
+        phdr[1].p_align = 0x1000;
+
+        std::vector<uint8_t> file(data_offset + DATA_SIZE, 0);
+        std::memcpy(file.data(), &ehdr, sizeof(ehdr));
+        std::memcpy(file.data() + sizeof(ehdr), phdr, sizeof(phdr));
+        std::memcpy(file.data() + code_offset, m_code.data(), m_code.size());
+        std::memcpy(file.data() + data_offset, data.data(), data.size());
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(file.data()), file.size());
+        return bool(out);
+    };
+
+    // Pcs of the compressed instructions
+    std::set<Addr_t> m_compressed;
+    // Targets of the taken control-flow instructions by pc
+    std::map<Addr_t, Addr_t> m_targets;
+    // Names of the checks, the exit code is one past the index
+    std::vector<std::string> m_checks;
+
+private:
+    std::vector<uint8_t> m_code;
+    std::vector<uint64_t> m_data;
+    std::vector<std::pair<size_t, uint32_t>> m_fixups;
+    std::vector<size_t> m_fails;
+};
+
+static auto assemble(Assembler &as) -> void
+{
+    // lui x31, DATA_BASE
+    as.word(uint32_t(DATA_BASE) | BASE << 7 | 0x37);
+
+    // 0. Compressed instructions, checked against their 32-bit meaning
+    as.half(0x5475); // c.li s0, -3
+    as.check("c.li", S0, uint64_t(-3));
+    as.half(0x0429); // c.addi s0, 10
+    as.check("c.addi", S0, 7);
+    as.half(0x0412); // c.slli s0, 4
+    as.check("c.slli", S0, 112);
+    as.half(0x8009); // c.srli s0, 2
+    as.check("c.srli", S0, 28);
+    as.half(0x54e1); // c.li s1, -8
+    as.half(0x8485); // c.srai s1, 1
+    as.check("c.srai", S1, uint64_t(-4));
+    as.half(0x8831); // c.andi s0, 12
+    as.check("c.andi", S0, 12);
+    as.half(0x8c05); // c.sub s0, s1
+    as.check("c.sub", S0, 16);
+    as.half(0x9c25); // c.addw s0, s1
+    as.check("c.addw", S0, 12);
+    as.half(0x82a2); // c.mv t0, s0
+    as.half(0x92a6); // c.add t0, s1
+    as.check("c.mv/c.add", T0, 8);
+    as.half(0x63fd); // c.lui t2, 0x1f
+    as.check("c.lui", T2, 0x1f000);
+    as.half(0x7381); // c.lui t2, 0xfffe0
+    as.check("c.lui negative", T2, 0xfffffffffffe0000);
+    as.half(0x0800); // c.addi4spn s0, sp, 16
+    as.r(0x20, SP, S0, 0, T0, 0x33); // sub t0, s0, sp
+    as.check("c.addi4spn", T0, 16);
+    as.addi(A5, BASE, SCRATCH_OFFSET);
+    as.half(0xe784); // c.sd s1, 8(a5)
+    as.half(0x6788); // c.ld a0, 8(a5)
+    as.addi(T0, A0, 0);
+    as.check("c.sd/c.ld", T0, uint64_t(-4));
+    as.m_targets[as.pc()] = as.pc() + 4;
+    as.half(0xa011); // c.j +4
+    as.half(0x0000);
+    as.m_targets[as.pc()] = as.pc() + 4;
+    as.half(0xe011); // c.bnez s0, +4
+    as.half(0x0000);
+
+    // 1. Branch and jump immediates
+    as.addi(T0, X0, 0);
+    as.addi(T2, X0, 3);
+    const Addr_t loop = as.pc();
+    as.addi(T0, T0, 1);
+    as.addi(T2, T2, -1);
+    as.branch(1, T2, X0, loop, false); // bne t2, x0, loop
+    as.check("backward bne", T0, 3);
+
+    // Far forward jal over a padding of zeros, back with a far beq, out with a jal
+    const size_t over = as.jal(X0);
+    const Addr_t back = as.pc();
+    as.addi(T0, X0, 7);
+    const size_t out = as.jal(X0);
+    for (int k = 0; k < 0x240; ++k)
+    {
+        as.word(0);
+    }
+    as.bind(over);
+    as.branch(0, X0, X0, back); // beq x0, x0, back
+    as.bind(out);
+    as.check("far jal/beq", T0, 7);
+
+    const Addr_t call = as.pc();
+    as.jal(RA, call + 8);
+    as.word(0);
+    as.check("jal link", RA, call + 4);
+    const Addr_t auipc = as.pc();
+    as.word(T2 << 7 | 0x17); // auipc t2, 0
+    as.m_targets[as.pc()] = auipc + 12;
+    as.i(12, T2, 0, T0, 0x67); // jalr t0, 12(t2)
+    as.word(0);
+    as.check("jalr link", T0, auipc + 8);
+
+    as.addi(S1, X0, -4);
+    as.addi(T0, X0, 0);
+    as.branch(4, S1, X0, as.pc() + 8); // blt s1, x0
+    as.addi(T0, T0, 1);
+    as.branch(6, S1, X0, as.pc() + 8, false); // bltu s1, x0
+    as.addi(T0, T0, 2);
+    as.branch(7, S1, X0, as.pc() + 8); // bgeu s1, x0
+    as.addi(T0, T0, 4);
+    as.check("signed and unsigned compares", T0, 2);
+
+    // 2. Division by zero and signed overflow
+    as.li(S0, 0x8000000000000000);
+    as.li(S1, uint64_t(-1));
+    as.addi(A1, X0, 0);
+    as.addi(A2, X0, 42);
+    as.r(1, S1, S0, 4, T0, 0x33); // div
+    as.check("div overflow", T0, 0x8000000000000000);
+    as.r(1, S1, S0, 6, T0, 0x33); // rem
+    as.check("rem overflow", T0, 0);
+    as.r(1, A1, A2, 4, T0, 0x33); // div
+    as.check("div by zero", T0, uint64_t(-1));
+    as.r(1, A1, A2, 5, T0, 0x33); // divu
+    as.check("divu by zero", T0, ~uint64_t(0));
+    as.r(1, A1, A2, 6, T0, 0x33); // rem
+    as.check("rem by zero", T0, 42);
+    as.r(1, A1, A2, 7, T0, 0x33); // remu
+    as.check("remu by zero", T0, 42);
+    as.li(S0, 0xffffffff80000000);
+    as.r(1, S1, S0, 4, T0, 0x3b); // divw
+    as.check("divw overflow", T0, 0xffffffff80000000);
+    as.r(1, S1, S0, 6, T0, 0x3b); // remw
+    as.check("remw overflow", T0, 0);
+    as.r(1, A1, S0, 5, T0, 0x3b); // divuw
+    as.check("divuw by zero", T0, ~uint64_t(0));
+    as.r(1, A1, S0, 7, T0, 0x3b); // remuw
+    as.check("remuw by zero", T0, 0xffffffff80000000);
+    as.r(1, S1, S1, 1, T0, 0x33); // mulh
+    as.check("mulh", T0, 0);
+    as.r(1, S1, S1, 3, T0, 0x33); // mulhu
+    as.check("mulhu", T0, 0xfffffffffffffffe);
+    as.r(1, S1, S1, 2, T0, 0x33); // mulhsu
+    as.check("mulhsu", T0, ~uint64_t(0));
+
+    // 3. Reservations and atomics on the scratch words
+    as.addi(A5, BASE, SCRATCH_OFFSET);
+    as.li(S0, 0x1122334455667788);
+    as.addi(S1, X0, 5);
+    as.amo(0x02, 3, T0, A5, X0); // lr.d
+    as.amo(0x03, 3, T2, A5, S0); // sc.d
+    as.check("sc.d after lr.d", T2, 0);
+    as.amo(0x03, 3, T2, A5, S1); // sc.d
+    as.check("sc.d without reservation", T2, 1);
+    as.ld(T0, A5, 0);
+    as.check("sc.d stored", T0, 0x1122334455667788);
+    as.amo(0x00, 2, T0, A5, S1); // amoadd.w
+    as.check("amoadd.w old value", T0, 0x55667788);
+    as.i(0, A5, 6, T0, 0x03); // lwu
+    as.check("amoadd.w new value", T0, 0x5566778d);
+    as.addi(S1, X0, -1);
+    as.amo(0x14, 2, T0, A5, S1); // amomax.w
+    as.i(0, A5, 2, T0, 0x03); // lw
+    as.check("amomax.w", T0, 0x5566778d);
+    as.amo(0x18, 3, T0, A5, S1); // amominu.d
+    as.ld(T0, A5, 0);
+    as.check("amominu.d", T0, 0x112233445566778d);
+    as.amo(0x01, 3, T0, A5, S1); // amoswap.d
+    as.check("amoswap.d old value", T0, 0x112233445566778d);
+    as.ld(T0, A5, 0);
+    as.check("amoswap.d new value", T0, ~uint64_t(0));
+
+    // 4. Syscalls proxied to the host or emulated
+    const std::string message = GUEST_MESSAGE;
+    as.addi(A0, X0, 1);
+    as.addi(A1, BASE, STRING_OFFSET);
+    as.addi(A2, X0, int64_t(message.size()));
+    as.addi(A7, X0, 64);
+    as.ecall();
+    as.addi(T0, A0, 0);
+    as.check("write", T0, message.size());
+    as.addi(A0, X0, -100);
+    as.addi(A1, BASE, STRING_OFFSET + message.size() + 1);
+    as.addi(A2, X0, 0);
+    as.addi(A3, X0, 0);
+    as.addi(A7, X0, 56);
+    as.ecall();
+    as.addi(T0, A0, 0);
+    as.check("openat missing file", T0, uint64_t(-ENOENT));
+    as.addi(A0, X0, 0);
+    as.addi(A7, X0, 214);
+    as.ecall();
+    as.addi(T0, A0, 0);
+    as.check("brk query", T0, DATA_BASE + DATA_SIZE);
+    as.li(A0, DATA_BASE + DATA_SIZE + 0x2000);
+    as.ecall();
+    as.addi(T0, A0, 0);
+    as.check("brk grow", T0, DATA_BASE + DATA_SIZE + 0x2000);
+    as.addi(A7, X0, 172);
+    as.ecall();
+    as.addi(T0, A0, 0);
+    as.check("getpid", T0, 1);
+    as.addi(A7, X0, 500);
+    as.ecall();
+    as.addi(T0, A0, 0);
+    as.check("unknown syscall", T0, uint64_t(-ENOSYS));
+
+    // 5. Exit with zero, or with the number of the failing check
+    as.addi(A0, X0, 0);
+    as.addi(A7, X0, 93);
+    as.ecall();
+    as.fail();
+}
+
+// Run a hand-assembled guest and check the results of every instruction class
+int main(int argc, char const *argv[])
+{
+    Assembler as;
+    assemble(as);
+    const std::string message = GUEST_MESSAGE;
+    const std::string path = "/tmp/riscv_interpreter_test_" + std::to_string(::getpid());
+    if (!as.write(path, message + '\0' + "/nonexistent/archXplore" + '\0'))
+    {
+        std::cerr << "Unable to write " << path << std::endl;
+        return 1;
+    }
+
+    uint64_t steps = 0, syscalls = 0, bad_compressed = 0, bad_targets = 0;
+    try
+    {
+        iss::riscv::RiscvInterpreter interpreter(path, {});
+        cpu::StaticInst_t inst;
+        while (!interpreter.exited() && steps < 100000)
+        {
+            const auto result = interpreter.step(inst);
+            steps++;
+            syscalls += (result == iss::riscv::StepResult_t::SYSCALL);
+            if (as.m_compressed.count(inst.pc) != 0 && inst.len != 2)
+            {
+                std::cerr << "Compressed instruction at 0x" << std::hex << inst.pc << std::dec
+                          << " has length " << int(inst.len) << std::endl;
+                bad_compressed++;
+            }
+            auto target = as.m_targets.find(inst.pc);
+            if (target != as.m_targets.end() && (!inst.br_info.redirect || inst.br_info.target_pc != target->second))
+            {
+                std::cerr << "Instruction at 0x" << std::hex << inst.pc << " went to 0x" << inst.br_info.target_pc
+                          << " instead of 0x" << target->second << std::dec << std::endl;
+                bad_targets++;
+            }
+        }
+        ::unlink(path.c_str());
+        if (!interpreter.exited())
+        {
+            std::cerr << "The guest did not exit after " << steps << " instructions" << std::endl;
+            return 1;
+        }
+        const int64_t code = interpreter.exitCode();
+        if (code != 0)
+        {
+            std::cerr << "Check failed: "
+                      << (code > 0 && code <= int64_t(as.m_checks.size()) ? as.m_checks[code - 1] : "unknown")
+                      << std::endl;
+            return 1;
+        }
+    }
+    catch (const std::runtime_error &e)
+    {
+        ::unlink(path.c_str());
+        std::cerr << "Interpreter stopped: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Instructions: " << steps << std::endl;
+    std::cout << "Syscalls: " << syscalls << std::endl;
+    std::cout << "Checks: " << as.m_checks.size() << std::endl;
+    if (bad_compressed != 0 || bad_targets != 0 || syscalls != 6)
+    {
+        return 1;
+    }
+    return 0;
+}
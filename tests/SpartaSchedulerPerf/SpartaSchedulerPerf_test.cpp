@@ -3,6 +3,16 @@
 #include "sparta/events/Event.hpp"
 #include "sparta/events/StartupEvent.hpp"
 
+#include <cstring>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "iss/WaitPolicy.hpp"
+#include "utils/SpinBarrier.hpp"
+#include "utils/ThreadPool.hpp"
+
 #define PERF_CYCLE 100000000
 
 class perfUnit : public sparta::Unit
@@ -31,8 +41,120 @@ private:
     sparta::Counter m_perf_counter;
 };
 
+// A scheduler with its own clock and unit, run by one thread per interval
+struct perfRank
+{
+    perfRank(const std::string &name)
+        : rtn(name), scheduler("Scheduler" + name), clk("Clock" + name, &scheduler)
+    {
+        rtn.setClock(&clk);
+        unit = std::make_unique<perfUnit>(&rtn);
+        rtn.enterConfiguring();
+        rtn.enterFinalized();
+        scheduler.finalize();
+    };
+
+    ~perfRank()
+    {
+        rtn.enterTeardown();
+    };
+
+    sparta::RootTreeNode rtn;
+    sparta::Scheduler scheduler;
+    sparta::Clock clk;
+    std::unique_ptr<perfUnit> unit;
+};
+
+// Run every rank for a number of intervals, one thread pool task per rank and interval
+double runThreadPool(std::vector<std::unique_ptr<perfRank>> &ranks, const uint64_t &intervals, const uint64_t &interval_cycles)
+{
+    archXplore::utils::ThreadPool pool(ranks.size());
+    std::vector<std::future<void>> futures;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint64_t i = 0; i < intervals; ++i)
+    {
+        for (auto &rank : ranks)
+        {
+            futures.push_back(pool.enqueue([&]() { rank->scheduler.run(interval_cycles, true, false); }));
+        }
+        for (auto &f : futures)
+        {
+            f.get();
+        }
+        futures.clear();
+    }
+    auto stop = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+// Run every rank for a number of intervals, one persistent worker per rank between two barrier crossings
+double runSpinBarrier(std::vector<std::unique_ptr<perfRank>> &ranks, const uint64_t &intervals, const uint64_t &interval_cycles,
+                      const uint32_t &spin_count)
+{
+    archXplore::utils::SpinBarrier barrier(ranks.size() + 1, spin_count);
+    std::vector<std::thread> workers;
+    for (auto &rank : ranks)
+    {
+        workers.emplace_back([&]()
+                             {
+            for (uint64_t i = 0; i < intervals; ++i)
+            {
+                barrier.arriveAndWait();
+                rank->scheduler.run(interval_cycles, true, false);
+                barrier.arriveAndWait();
+            } });
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint64_t i = 0; i < intervals; ++i)
+    {
+        barrier.arriveAndWait();
+        barrier.arriveAndWait();
+    }
+    auto stop = std::chrono::high_resolution_clock::now();
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+// Usage: SpartaSchedulerPerfTest barrier [max ranks] [intervals] [cycles per interval] [barrier spin count]
+int barrierPerf(int argc, char const *argv[])
+{
+    const uint64_t max_ranks = argc > 2 ? std::stoull(argv[2]) : std::thread::hardware_concurrency();
+    const uint64_t intervals = argc > 3 ? std::stoull(argv[3]) : 10000;
+    const uint64_t interval_cycles = argc > 4 ? std::stoull(argv[4]) : 1000;
+    // The system spins on its phase barrier as long as its wait policy allows
+    const uint32_t spin_count = argc > 5 ? std::stoul(argv[5]) : archXplore::iss::WaitPolicy_t().spin_count;
+
+    std::cout << "Intervals: " << intervals << ", cycles per interval: " << interval_cycles
+              << ", barrier spin count: " << spin_count << std::endl;
+    for (uint64_t num_ranks = 1; num_ranks <= max_ranks; num_ranks *= 2)
+    {
+        std::vector<std::unique_ptr<perfRank>> ranks;
+        for (uint64_t i = 0; i < num_ranks; ++i)
+        {
+            ranks.push_back(std::make_unique<perfRank>("Rank" + std::to_string(i)));
+        }
+        double pool_time = runThreadPool(ranks, intervals, interval_cycles);
+        double barrier_time = runSpinBarrier(ranks, intervals, interval_cycles, spin_count);
+
+        // Output the cost of one interval with either synchronization
+        std::cout << "Ranks: " << num_ranks
+                  << ", thread pool: " << pool_time / intervals * 1e6 << " us/interval"
+                  << ", spin barrier: " << barrier_time / intervals * 1e6 << " us/interval"
+                  << std::endl;
+    }
+    return 0;
+}
+
 int main(int argc, char const *argv[])
 {
+    if (argc > 1 && std::strcmp(argv[1], "barrier") == 0)
+    {
+        return barrierPerf(argc, argv);
+    }
+
     sparta::RootTreeNode rtn;
 
     sparta::Scheduler schduler("Schduler");
@@ -0,0 +1,79 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+#include "iss/synthetic/SyntheticGenerator.hpp"
+
+using namespace archXplore;
+
+// Largest accepted difference between a generated and a requested fraction
+static constexpr double TOLERANCE = 0.005;
+
+// Generate one stream per address pattern and check the produced mix against the requested one
+int main(int argc, char const *argv[])
+{
+    iss::synthetic::SyntheticMix_t mix;
+    mix.num_insts = 50000000;
+    mix.syscall_interval = 100000;
+
+    for (auto pattern : {iss::synthetic::AddressPattern_t::STRIDED,
+                         iss::synthetic::AddressPattern_t::RANDOM,
+                         iss::synthetic::AddressPattern_t::STACK})
+    {
+        mix.pattern = pattern;
+        iss::synthetic::SyntheticGenerator generator(mix);
+        cpu::StaticInst_t inst;
+        uint64_t branches = 0, taken = 0, loads = 0, stores = 0, syscalls = 0, broken = 0;
+        Addr_t expected_pc = generator.nextPC();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        while (generator.remaining() > 0)
+        {
+            syscalls += generator.next(inst);
+            branches += (inst.func_info == cpu::TYPE_BRANCH);
+            taken += (inst.func_info == cpu::TYPE_BRANCH && inst.br_info.redirect);
+            loads += (inst.func_info == cpu::TYPE_LOAD);
+            stores += (inst.func_info == cpu::TYPE_STORE);
+            broken += (inst.pc != expected_pc);
+            expected_pc = inst.br_info.redirect ? inst.br_info.target_pc : inst.pc + inst.len;
+        }
+        auto stop = std::chrono::high_resolution_clock::now();
+        const double seconds = std::chrono::duration<double>(stop - start).count();
+
+        if (broken != 0)
+        {
+            std::cout << "Control flow of the stream is broken at " << broken << " instructions" << std::endl;
+            return 1;
+        }
+        const double n = double(mix.num_insts);
+        std::cout << "Pattern " << int(pattern) << ": "
+                  << mix.num_insts / seconds / 1e6 << " Minst/s, "
+                  << "branch " << branches / n << " (taken " << double(taken) / branches << "), "
+                  << "load " << loads / n << ", store " << stores / n << ", "
+                  << "syscalls " << syscalls << std::endl;
+
+        // Every fraction of the stream must match the requested mix
+        const std::pair<const char *, std::pair<double, double>> fractions[] = {
+            {"branch", {branches / n, mix.branch_rate}},
+            {"taken", {double(taken) / branches, mix.taken_rate}},
+            {"load", {loads / n, mix.load_rate}},
+            {"store", {stores / n, mix.store_rate}}};
+        for (auto &fraction : fractions)
+        {
+            if (std::abs(fraction.second.first - fraction.second.second) > TOLERANCE)
+            {
+                std::cout << "The " << fraction.first << " fraction " << fraction.second.first
+                          << " is not within " << TOLERANCE << " of " << fraction.second.second << std::endl;
+                return 1;
+            }
+        }
+        if (syscalls != mix.num_insts / mix.syscall_interval)
+        {
+            std::cout << "Expected " << mix.num_insts / mix.syscall_interval << " syscalls" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}